@@ -57,12 +57,22 @@ namespace lsp
             static constexpr float PAUSE_DFL        = 10.0f;
             static constexpr float PAUSE_STEP       = 0.02f;
 
+            static constexpr size_t CHANNELS_MAX    = 2;
+
             static constexpr size_t MESH_POINTS     = 640;
             static constexpr float MESH_TIME        = 5.0f;
+
+            // Transition events stream: time in seconds, envelope, direction (0 = open,
+            // 1 = close), fade mode and channel index of each event
+            static constexpr size_t TRANSITION_FIELDS   = 5;
+            static constexpr size_t TRANSITION_FRAMES   = 0x20;
+            static constexpr size_t TRANSITION_CAPACITY = 0x400;
         };
 
         extern const meta::plugin_t surge_filter_mono;
         extern const meta::plugin_t surge_filter_stereo;
+        extern const meta::plugin_t sc_surge_filter_mono;
+        extern const meta::plugin_t sc_surge_filter_stereo;
     } // namespace meta
 } // namespace lsp
 
@@ -22,6 +22,7 @@
 #ifndef PRIVATE_PLUGINS_SURGE_FILTER_H_
 #define PRIVATE_PLUGINS_SURGE_FILTER_H_
 
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/plug-fw/plug.h>
 #include <lsp-plug.in/plug-fw/core/IDBuffer.h>
 #include <lsp-plug.in/dsp-units/ctl/Blink.h>
@@ -41,46 +42,196 @@ namespace lsp
          */
         class surge_filter: public plug::Module
         {
+            public:
+                enum transition_direction_t
+                {
+                    TD_OPEN,                            // Filter started to open
+                    TD_CLOSE                            // Filter became closed
+                };
+
+                /**
+                 * Gate transition event
+                 */
+                typedef struct transition_t
+                {
+                    wsize_t             nPosition;      // Position of the output sample the transition occurred at
+                    float               fEnvelope;      // Envelope value at the transition
+                    uint8_t             nDirection;     // Direction of transition, see transition_direction_t
+                    uint8_t             nMode;          // Fade mode in effect, dspu::depopper_mode_t
+                    uint8_t             nChannel;       // Index of the channel, always 0 in linked mode
+                } transition_t;
+
             protected:
+                /**
+                 * Per-channel state touched by the audio processing loop on each block
+                 */
                 typedef struct channel_t
                 {
                     float              *vIn;            // Input buffer
                     float              *vOut;           // Output buffer
+                    float              *vSc;            // Sidechain buffer, input buffer for versions without sidechain
+                    float              *vGc;            // Gain curve output buffer
                     float              *vBuffer;        // Buffer for processing
+                    float              *vGain;          // Control signal and gain curve
+                    float              *vEnv;           // Envelope
+                    float              *vTemp;          // Gain curve of the incoming detector on detection rate switch
+                    float               fGainMin;       // Minimum gain of the current block
+                    float               fGainMax;       // Maximum gain of the current block
+                    float               fLastGain;      // Last gain value of the previous block
+                    float               fLastEnv;       // Last envelope value of the previous block
+                    float               fCtlSum;        // Sum of squares of the current control period
+                    float               fCtlPrev;       // Gain at the previous control point
+                    float               fCtlLast;       // Gain at the last control point
+                    float               fCtlEnvPrev;    // Envelope at the previous control point
+                    float               fCtlEnv;        // Envelope at the last control point
+                    size_t              nCtlPos;        // Position inside of the current control period
+
+                    plug::IPort        *pIn;            // Input port
+                    plug::IPort        *pOut;           // Output port
+                    plug::IPort        *pSc;            // Sidechain port
+                    plug::IPort        *pGc;            // Gain curve output port
+
                     dspu::Bypass        sBypass;        // Bypass
-                    dspu::Delay         sDelay;         // Delay for latency compensation
-                    dspu::Delay         sDryDelay;      // Dry delay
-                    dspu::MeterGraph    sIn;            // Input metering graph
-                    dspu::MeterGraph    sOut;           // Output metering graph
+                    dspu::Delay         sDelay;         // Delay of the input signal for latency compensation
+                    dspu::Delay         sGainDelay;     // Delay of the gain curve of the detector with lower latency
+                    dspu::Delay         sEnvDelay;      // Delay of the envelope of the detector with lower latency
+                    dspu::Depopper      sDepopper;      // Depopper module
+                    dspu::Depopper      sCtlDepopper;   // Depopper module operating at control rate
+                } channel_t;
+
+                /**
+                 * Per-channel metering and visualization state, touched only when metering is enabled
+                 */
+                typedef struct meter_t
+                {
+                    float               fInLevel;       // Input peak level
+                    float               fOutLevel;      // Output peak level
+                    float               fGainLevel;     // Gain level for metering
+                    float               fEnvLevel;      // Envelope level for metering
                     bool                bInVisible;     // Input signal visibility flag
                     bool                bOutVisible;    // Output signal visibility flag
+                    dspu::MeterGraph    sIn;            // Input metering graph
+                    dspu::MeterGraph    sOut;           // Output metering graph
+                    dspu::MeterGraph    sGain;          // Gain metering graph
+                    dspu::MeterGraph    sEnv;           // Envelope metering graph
 
-                    plug::IPort        *pIn;            // Input port
-                    plug::IPort        *pOut;           // Output port
                     plug::IPort        *pInVisible;     // Input visibility
                     plug::IPort        *pOutVisible;    // Output visibility
                     plug::IPort        *pMeterIn;       // Input Meter
                     plug::IPort        *pMeterOut;      // Output Meter
-                } channel_t;
+                    plug::IPort        *pGainMeter;     // Gain reduction meter
+                    plug::IPort        *pEnvMeter;      // Envelope meter
+                } meter_t;
+
+                /**
+                 * Snapshot of graph data published by the processing thread for the inline display
+                 */
+                typedef struct snapshot_t
+                {
+                    float              *vData;          // Input, output, envelope and gain graphs of each channel
+                    size_t              nDetectors;     // Number of channels with own envelope and gain graphs
+                    bool                vInVisible[meta::surge_filter_metadata::CHANNELS_MAX];  // Input graph of the channel is visible
+                    bool                vOutVisible[meta::surge_filter_metadata::CHANNELS_MAX]; // Output graph of the channel is visible
+                    bool                bBypass;        // Bypass is on
+                    bool                bEnvVisible;    // Envelope graph is visible
+                    bool                bGainVisible;   // Gain graph is visible
+                } snapshot_t;
+
+                typedef void (surge_filter::*process_blocks_t)(size_t samples, bool metering);
+
+            #ifdef LSP_INSTRUMENT
+                enum profile_stage_t
+                {
+                    PS_INPUT_GAIN,
+                    PS_INPUT_METER,
+                    PS_CONTROL,
+                    PS_DEPOPPER,
+                    PS_GAIN_METER,
+                    PS_DELAY,
+                    PS_BYPASS,
+                    PS_OUTPUT_METER,
+                    PS_MESH,
+
+                    // Stages executed outside of the processing thread
+                    PS_IDISPLAY,
+
+                    PS_TOTAL
+                };
+
+                /**
+                 * Profile counters guarded by the sequence lock: the writer increments the sequence
+                 * number before and after the update, the reader retries while the number is odd
+                 * or has changed during the read
+                 */
+                typedef struct profile_t
+                {
+                    mutable uatomic_t   nSeq;               // Sequence number
+                    wsize_t             vTotal[PS_TOTAL];   // Overall number of cycles spent in each stage
+                    wsize_t             vPeak[PS_TOTAL];    // Peak number of cycles spent in each stage per call
+                    wsize_t             nCalls;             // Number of profiled calls
+                } profile_t;
+            #endif /* LSP_INSTRUMENT */
 
             protected:
+                // State accessed by the audio processing loop on each block
                 size_t              nChannels;          // Number of channels
                 channel_t          *vChannels;          // Array of channels
-                float              *vBuffer;            // Buffer for processing
-                float              *vEnv;               // Envelope
-                float              *vTimePoints;        // Time points
-                float              *vIDisplay;          // Buffer for inline display
+                process_blocks_t    pProcessBlocks;     // Processing routine
                 float               fGainIn;            // Input gain
                 float               fGainOut;           // Output gain
+                bool                bSidechain;         // External sidechain
+                bool                bLink;              // Channels are linked
+                size_t              nLinkSwitch;        // Number of samples left to complete unlinking of channels
+                bool                bControlRate;       // Control-rate detection is used for the gain curve
+                bool                bCtlDelayed;        // Gain curve of control-rate detection is delayed on detection rate switch
+                size_t              nGainDelay;         // Delay of the gain curve of the detector with lower latency on detection rate switch
+                size_t              nCtlSwitch;         // Number of samples left to complete the detection rate switch
+                size_t              nCtlXFade;          // Length of the gain cross-fade on detection rate switch
+                bool                bMetering;          // Metering is enabled
+                bool                bSleep;             // Sleep mode
+                size_t              nSilence;           // Number of samples of digital silence at the input
+                size_t              nSleepThresh;       // Number of samples of silence to enter sleep mode
+                wsize_t             nSleepTime;         // Overall number of samples processed in sleep mode
+                wsize_t             nPosition;          // Current position of the output stream
+                transition_t       *vTransitions;       // Ring buffer of transition events
+                uatomic_t           nTrHead;            // Write position in the transition ring buffer
+                uatomic_t           nTrTail;            // Read position in the transition ring buffer
+                uatomic_t           nTrLost;            // Number of lost transition events
+
+                // State accessed on parameter changes, by metering and by the UI
+                meter_t            *vMeters;            // Array of channel meters
+                float              *vTimePoints;        // Time points
+                float               fThreshOn;          // Fade in threshold
+                float               fThreshOff;         // Fade out threshold
+                float               fFadeIn;            // Fade in time
+                float               fFadeOut;           // Fade out time
+                float               fFadeInDelay;       // Fade in cancel delay
+                float               fFadeOutDelay;      // Fade out cancel delay
+                float               fRmsLen;            // RMS estimation length
+                dspu::depopper_mode_t   nModeIn;        // Fade in mode
+                dspu::depopper_mode_t   nModeOut;       // Fade out mode
+                size_t              nLatency;           // Actual latency
+                size_t              nDelayCap;          // Capacity of delay lines in samples
+            #ifdef LSP_INSTRUMENT
+                profile_t           sProfile;               // Counters of stages updated by the processing thread
+                profile_t           sIDProfile;             // Counters of the inline display stage
+                wsize_t             vProfileCall[PS_TOTAL]; // Number of cycles spent in each stage by current call
+            #endif /* LSP_INSTRUMENT */
                 bool                bGainVisible;       // Gain visible
                 bool                bEnvVisible;        // Envelope visible
+                bool                bMeterSync;         // Metering graphs need to be synchronized
+                bool                bUISync;            // UI has been activated
+                uatomic_t           nIDisplayReq;       // Number of inline display draw requests
+                uatomic_t           nIDisplayAck;       // Last acknowledged number of inline display draw requests
+                size_t              nIDisplayTimeout;   // Inline display activity timeout
+                snapshot_t          vSnapshots[3];      // Triple buffer of snapshots for the inline display
+                uatomic_t           nSnapMiddle;        // Index of the published snapshot and dirty flag
+                size_t              nSnapBack;          // Index of the snapshot owned by the processing thread
+                size_t              nSnapFront;         // Index of the snapshot owned by the inline display
                 uint8_t            *pData;              // Allocated data
                 core::IDBuffer     *pIDisplay;          // Inline display buffer
 
-                dspu::MeterGraph    sGain;              // Gain metering graph
-                dspu::MeterGraph    sEnv;               // Envelop metering graph
                 dspu::Blink         sActive;            // Activity indicator
-                dspu::Depopper      sDepopper;          // Depopper module
 
                 plug::IPort        *pModeIn;            // Mode for fade in
                 plug::IPort        *pModeOut;           // Mode for fade out
@@ -103,12 +254,44 @@ namespace lsp
                 plug::IPort        *pEnvVisible;        // Envelope mesh visibility
                 plug::IPort        *pGainMeter;         // Gain reduction meter
                 plug::IPort        *pEnvMeter;          // Envelope meter
+                plug::IPort        *pLink;              // Stereo link
+                plug::IPort        *pControlRate;       // Control-rate detection
+                plug::IPort        *pTransitions;       // Stream of transition events
 
             protected:
                 void                do_destroy();
+                void                invalidate_settings();
+                void                reset_control_rate();
+                bool                update_latency();
+                void                prime_gain_delay();
+                void                process_control_rate(channel_t *c, float *gain, float *env, size_t samples);
+                void                process_detector(channel_t *c, bool crate, float *gain, float *env, size_t samples);
+                void                crossfade_detectors(channel_t *c, size_t samples);
+                void                crossfade_link(size_t samples);
+                template <size_t CHANNELS>
+                bool                input_silent(size_t samples) const;
+                template <size_t CHANNELS>
+                void                process_sleep(size_t samples, bool metering);
+                template <size_t CHANNELS>
+                void                process_blocks(size_t samples, bool metering);
+                bool                update_metering(size_t samples);
+                void                sync_metering();
+                void                output_meshes();
+                void                publish_snapshot();
+                bool                draw_inline_display(plug::ICanvas *cv, size_t width, size_t height);
+                void                push_transition(size_t channel, size_t offset, bool open);
+                void                detect_transitions(size_t channel, size_t samples);
+                void                output_transitions();
+            #ifdef LSP_INSTRUMENT
+                inline wsize_t      profile_stage(size_t stage, wsize_t start);
+                void                profile_commit();
+                static void         profile_update(profile_t *p, const wsize_t *cycles, size_t first, size_t count);
+                static void         profile_read(profile_t *dst, const profile_t *src);
+            #endif /* LSP_INSTRUMENT */
+                size_t              channel_color_id(size_t index) const;
 
             public:
-                explicit            surge_filter(const meta::plugin_t *metadata, size_t channels);
+                explicit            surge_filter(const meta::plugin_t *metadata, bool sc, size_t channels);
                 virtual            ~surge_filter() override;
 
                 virtual void        init(plug::IWrapper *wrapper, plug::IPort **ports) override;
@@ -118,8 +301,28 @@ namespace lsp
                 virtual void        update_sample_rate(long sr) override;
                 virtual void        update_settings() override;
                 virtual void        process(size_t samples) override;
+                virtual void        ui_activated() override;
                 virtual bool        inline_display(plug::ICanvas *cv, size_t width, size_t height) override;
                 virtual void        dump(dspu::IStateDumper *v) const override;
+
+            public:
+                /**
+                 * Read gate transition events emitted by the processing thread. The method
+                 * is lock-free and may be called from any single non-RT thread. If the
+                 * stream port of transitions is connected, the events are consumed by
+                 * process() and this method should not be used
+                 *
+                 * @param dst destination buffer to store events
+                 * @param count maximum number of events to read
+                 * @return number of events read
+                 */
+                size_t              read_transitions(transition_t *dst, size_t count);
+
+                /**
+                 * Get the number of transition events lost due to overflow of the ring buffer
+                 * @return number of lost transition events
+                 */
+                inline uatomic_t    lost_transitions()          { return atomic_load(&nTrLost); }
         };
     } /* namespace plugins */
 } /* namespace lsp */
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_TEST_BASELINE_FILTER_H_
+#define PRIVATE_TEST_BASELINE_FILTER_H_
+
+#include <lsp-plug.in/dsp-units/ctl/Bypass.h>
+#include <lsp-plug.in/dsp-units/util/Delay.h>
+#include <lsp-plug.in/dsp-units/util/Depopper.h>
+#include <private/test/config.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Reference model of the audio path of the surge filter as it was before the block
+         * processing: the input gain, the absolute maximum of all channels as the control
+         * signal, the depopper, the latency compensation and the output gain are applied
+         * in the same order with the same DSP functions
+         */
+        class BaselineFilter
+        {
+            protected:
+                typedef struct channel_t
+                {
+                    dspu::Bypass        sBypass;        // Bypass
+                    dspu::Delay         sDelay;         // Delay of the processed signal
+                    dspu::Delay         sDryDelay;      // Delay of the dry signal
+                    float              *vBuffer;        // Processed signal
+                } channel_t;
+
+            protected:
+                dspu::Depopper          sDepopper;      // Depopper
+                channel_t               vChannels[2];   // Channels
+                size_t                  nChannels;      // Number of channels
+                float                   fGainIn;        // Input gain
+                float                   fGainOut;       // Output gain
+                float                  *vBuffer;        // Control signal
+                float                  *vEnv;           // Envelope
+                uint8_t                *pData;          // Allocated data
+
+            public:
+                explicit BaselineFilter(size_t channels);
+                BaselineFilter(const BaselineFilter &) = delete;
+                BaselineFilter(BaselineFilter &&) = delete;
+                ~BaselineFilter();
+
+                BaselineFilter & operator = (const BaselineFilter &) = delete;
+                BaselineFilter & operator = (BaselineFilter &&) = delete;
+
+            public:
+                /**
+                 * Initialize the model
+                 *
+                 * @param sample_rate sample rate
+                 * @return status of operation
+                 */
+                status_t            init(long sample_rate);
+
+                /**
+                 * Destroy the model
+                 */
+                void                destroy();
+
+                /**
+                 * Apply the set of parameters, the control-rate detection is not supported
+                 *
+                 * @param cfg set of parameters
+                 * @param gain_in input gain
+                 * @param gain_out output gain
+                 */
+                void                apply(const config_t *cfg, float gain_in, float gain_out);
+
+                /**
+                 * Process the data
+                 *
+                 * @param out output buffers, one per channel
+                 * @param in input buffers, one per channel
+                 * @param samples number of samples to process
+                 */
+                void                process(float * const *out, const float * const *in, size_t samples);
+
+            public:
+                inline size_t       channels() const    { return nChannels;                 }
+                inline size_t       latency() const     { return sDepopper.latency();       }
+        };
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* PRIVATE_TEST_BASELINE_FILTER_H_ */
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_BENCHMARK_H_
+#define PRIVATE_TEST_BENCHMARK_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/types.h>
+#include <private/test/signal.h>
+#include <private/test/surge_filter_host.h>
+
+#include <stdio.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Result of the benchmark
+         */
+        typedef struct bench_t
+        {
+            size_t      nBlock;             // Size of the block passed to the process() call
+            size_t      nBlocks;            // Number of measured process() calls
+            double      fNsPerSample;       // Average time per sample, nanoseconds
+            double      fCyclesPerSample;   // Average number of CPU cycles per sample, 0 if not supported
+            double      fP99Ns;             // 99th percentile of the process() call time, nanoseconds
+        } bench_t;
+
+        /**
+         * Input data of the benchmark
+         */
+        enum bench_load_t
+        {
+            BL_OPEN,            // Noise above the threshold, the filter is open
+            BL_CLOSED,          // Noise below the threshold, the filter is closed but does not sleep
+            BL_FADE,            // Bursts shorter than fade times, the filter is fading most of the time
+            BL_GAPS             // Noise interrupted by silence gaps of different length
+        };
+
+        /**
+         * Routine called before each process() call, may change parameters of the plugin
+         *
+         * @param host plugin host
+         * @param index index of the call
+         * @param arg argument passed to the benchmark
+         */
+        typedef void (* bench_hook_t)(SurgeFilterHost *host, size_t index, void *arg);
+
+        /**
+         * Benchmark of the process() call: feeds the plugin with the periodic input
+         * signal, measures the time of each call and writes results to the report
+         * in CSV format
+         */
+        class Benchmark
+        {
+            protected:
+                float          *vIn[2];         // Input data, one period followed by the copy of its beginning
+                float          *vOut[2];        // Output data
+                long            nSampleRate;    // Sample rate
+                size_t          nPeriod;        // Period of the input data
+                size_t          nMaxBlock;      // Maximum block size
+                size_t          nOffset;        // Current offset in the input data
+                double         *vTimes;         // Times of process() calls
+                size_t          nMaxBlocks;     // Maximum number of measured calls
+                bench_hook_t    pHook;          // Routine called before each process() call
+                void           *pHookArg;       // Argument of the routine
+                size_t          nHookIndex;     // Index of the next call of the routine
+                FILE           *pReport;        // Report file
+
+            protected:
+                void            process(SurgeFilterHost *host, size_t block);
+
+            public:
+                explicit Benchmark();
+                Benchmark(const Benchmark &) = delete;
+                Benchmark(Benchmark &&) = delete;
+                ~Benchmark();
+
+                Benchmark & operator = (const Benchmark &) = delete;
+                Benchmark & operator = (Benchmark &&) = delete;
+
+            public:
+                /**
+                 * Allocate buffers
+                 *
+                 * @param sample_rate sample rate of the input data
+                 * @param period period of the input data in samples
+                 * @param max_block maximum block size
+                 * @param max_blocks maximum number of measured process() calls
+                 * @return status of operation
+                 */
+                status_t        init(long sample_rate, size_t period, size_t max_block, size_t max_blocks);
+
+                /**
+                 * Free all buffers and close the report
+                 */
+                void            destroy();
+
+                /**
+                 * Get the input buffer of the channel to fill one period of the input data,
+                 * commit() should be called after all channels have been filled
+                 *
+                 * @param channel channel number
+                 * @return input buffer
+                 */
+                inline float   *input(size_t channel)       { return vIn[channel]; }
+
+                /**
+                 * Make the input data periodic and rewind to the beginning
+                 */
+                void            commit();
+
+                /**
+                 * Generate one period of the input data of all channels and commit it
+                 *
+                 * @param load type of the input data
+                 */
+                void            generate(bench_load_t load);
+
+                /**
+                 * Set the routine called before each process() call, the time of the routine
+                 * is not included into the measured time
+                 *
+                 * @param hook routine, may be NULL
+                 * @param arg argument passed to the routine
+                 */
+                void            set_hook(bench_hook_t hook, void *arg);
+
+                /**
+                 * Process the next block of the input data, the hook is called before
+                 *
+                 * @param host plugin host
+                 * @param block size of the block
+                 */
+                void            run(SurgeFilterHost *host, size_t block);
+
+                /**
+                 * Bring the plugin to the steady state: process one period of the input data
+                 *
+                 * @param host plugin host
+                 */
+                void            warm_up(SurgeFilterHost *host);
+
+                /**
+                 * Process the specified number of blocks measuring the time of each call
+                 *
+                 * @param res result of the benchmark
+                 * @param host plugin host
+                 * @param block size of the block
+                 * @param blocks number of blocks to process
+                 */
+                void            measure(bench_t *res, SurgeFilterHost *host, size_t block, size_t blocks);
+
+                /**
+                 * Create the report file and write the header
+                 *
+                 * @param dir directory to store the report
+                 * @param name name of the report
+                 * @return status of operation
+                 */
+                status_t        open_report(const char *dir, const char *name);
+
+                /**
+                 * Write the result of the benchmark to the report
+                 *
+                 * @param name name of the benchmark
+                 * @param res result of the benchmark
+                 */
+                void            report(const char *name, const bench_t *res);
+        };
+
+    } /* namespace test */
+} /* namespace lsp */
+
+/**
+ * Benchmark the process() call of the plugin with the specified block size inside
+ * of the performance test: bring the plugin to the steady state, run the performance
+ * test loop, measure the time of each call and write the result to the report
+ *
+ * @param bench benchmark
+ * @param host plugin host
+ * @param name name of the benchmark, the key of the test loop is suffixed with the block size
+ * @param block size of the block
+ * @param blocks number of measured process() calls
+ * @param res result of the benchmark
+ */
+#define BENCHMARK_PROCESS(bench, host, name, block, blocks, res) \
+    { \
+        char __bench_key[128]; \
+        (bench)->warm_up(host); \
+        snprintf(__bench_key, sizeof(__bench_key), "%s/%d", (name), int(block)); \
+        PTEST_LOOP(__bench_key, \
+            (bench)->run(host, block); \
+        ); \
+        (bench)->measure(res, host, block, blocks); \
+        (bench)->report(name, res); \
+    }
+
+#endif /* PRIVATE_TEST_BENCHMARK_H_ */
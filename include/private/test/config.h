@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_CONFIG_H_
+#define PRIVATE_TEST_CONFIG_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Set of plugin parameters used by tests
+         */
+        typedef struct config_t
+        {
+            size_t      nModeIn;        // Fade in mode
+            size_t      nModeOut;       // Fade out mode
+            float       fThreshOn;      // Threshold for switching on
+            float       fThreshOff;     // Threshold for switching off
+            float       fRmsLen;        // RMS estimation time
+            float       fFadeIn;        // Fade in time
+            float       fFadeOut;       // Fade out time
+            float       fFadeInDelay;   // Fade in cancel delay time
+            float       fFadeOutDelay;  // Fade out cancel delay time
+            bool        bControlRate;   // Control-rate detection
+        } config_t;
+
+        /**
+         * Fill the configuration with default values of parameters
+         * @param cfg configuration to fill
+         */
+        void            config_default(config_t *cfg);
+
+        /**
+         * Get the number of configurations in the test grid
+         * @return number of configurations
+         */
+        size_t          config_grid_size();
+
+        /**
+         * Get configuration from the test grid. The grid covers all fade modes, two threshold
+         * pairs, two RMS lengths, two sets of fade times, two sets of cancel delays and both
+         * detection rates
+         *
+         * @param cfg configuration to fill
+         * @param index index of configuration in the grid
+         */
+        void            config_grid(config_t *cfg, size_t index);
+
+        /**
+         * Format the configuration as a short string
+         * @param dst destination buffer
+         * @param len size of destination buffer
+         * @param cfg configuration
+         */
+        void            config_format(char *dst, size_t len, const config_t *cfg);
+
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* PRIVATE_TEST_CONFIG_H_ */
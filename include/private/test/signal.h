@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_SIGNAL_H_
+#define PRIVATE_TEST_SIGNAL_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Deterministic test signals
+         */
+        enum signal_t
+        {
+            SIG_STEP,           // Silence, DC step up, DC step down to silence
+            SIG_BURSTS,         // Sine bursts separated by silence
+            SIG_DC,             // Constant DC signal
+            SIG_NOISE,          // White noise after a short silence
+            SIG_GAPS,           // White noise interrupted by silence gaps of different length
+            SIG_EDGE,           // Square wave which level alternates around the threshold
+
+            SIG_TOTAL
+        };
+
+        /**
+         * Get the name of the signal
+         * @param type signal type
+         * @return name of the signal
+         */
+        const char     *signal_name(signal_t type);
+
+        /**
+         * Generate the signal
+         *
+         * @param dst destination buffer
+         * @param count number of samples to generate
+         * @param type signal type
+         * @param level peak level of the signal, for SIG_EDGE the level around which the signal alternates
+         * @param sample_rate sample rate
+         * @param seed seed for the noise generator, also shifts the time of events
+         */
+        void            generate_signal(float *dst, size_t count, signal_t type, float level, long sample_rate, uint32_t seed);
+
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* PRIVATE_TEST_SIGNAL_H_ */
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_SURGE_FILTER_HOST_H_
+#define PRIVATE_TEST_SURGE_FILTER_HOST_H_
+
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/test/config.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Minimal host for tests: creates the plugin through the plugin factory, binds
+         * stub ports and drives process() with the data provided by the caller
+         */
+        class SurgeFilterHost
+        {
+            protected:
+                class Port;
+                class Wrapper;
+
+            protected:
+                const meta::plugin_t   *pMetadata;      // Plugin metadata
+                plug::Module           *pModule;        // Plugin instance
+                Wrapper                *pWrapper;       // Plugin wrapper
+                plug::IPort           **vPorts;         // All ports
+                size_t                  nPorts;         // Number of ports
+                Port                   *vIn[2];         // Input audio ports
+                Port                   *vOut[2];        // Output audio ports
+                Port                   *vSc[2];         // Sidechain audio ports
+                Port                   *vGc[2];         // Gain curve audio ports
+                Port                   *pBypass;        // Bypass port
+                size_t                  nChannels;      // Number of main channels
+                bool                    bUpdate;        // Settings need to be updated
+
+            protected:
+                Port                   *find_port(const char *id) const;
+
+            public:
+                explicit SurgeFilterHost(const meta::plugin_t *metadata);
+                SurgeFilterHost(const SurgeFilterHost &) = delete;
+                SurgeFilterHost(SurgeFilterHost &&) = delete;
+                ~SurgeFilterHost();
+
+                SurgeFilterHost & operator = (const SurgeFilterHost &) = delete;
+                SurgeFilterHost & operator = (SurgeFilterHost &&) = delete;
+
+            public:
+                /**
+                 * Create and initialize the plugin instance
+                 *
+                 * @param sample_rate sample rate
+                 * @return status of operation
+                 */
+                status_t            init(long sample_rate);
+
+                /**
+                 * Destroy the plugin instance and all ports
+                 */
+                void                destroy();
+
+                /**
+                 * Set value of the control port, settings are applied before the next block
+                 *
+                 * @param id port identifier
+                 * @param value value to set
+                 * @return true if port has been found
+                 */
+                bool                set(const char *id, float value);
+
+                /**
+                 * Get value of the port
+                 *
+                 * @param id port identifier
+                 * @return value of the port or 0 if port does not exist
+                 */
+                float               get(const char *id) const;
+
+                /**
+                 * Apply the set of parameters to the plugin
+                 * @param cfg set of parameters
+                 */
+                void                apply(const config_t *cfg);
+
+                /**
+                 * Set the bypass state
+                 * @param bypass bypass state
+                 */
+                void                set_bypass(bool bypass);
+
+                /**
+                 * Emulate the activity of the plugin UI which turns metering on
+                 * @param active UI activity flag
+                 */
+                void                set_ui_active(bool active);
+
+                /**
+                 * Process the data, the data is passed to the plugin in blocks of the specified
+                 * size. The gain curve output is stored only by versions with sidechain.
+                 *
+                 * @param out output buffers, one per channel
+                 * @param in input buffers, one per channel
+                 * @param sc sidechain buffers, one per channel, may be NULL, then the input is passed to the sidechain
+                 * @param gc gain curve buffers, one per channel, may be NULL
+                 * @param samples number of samples to process
+                 * @param block maximum number of samples passed to the process() call
+                 */
+                void                process(float * const *out, const float * const *in,
+                                        const float * const *sc, float * const *gc,
+                                        size_t samples, size_t block);
+
+                /**
+                 * Process the data, the size of each block passed to the process() call
+                 * is taken from the list of block sizes in the round-robin order
+                 *
+                 * @param out output buffers, one per channel
+                 * @param in input buffers, one per channel
+                 * @param sc sidechain buffers, one per channel, may be NULL, then the input is passed to the sidechain
+                 * @param gc gain curve buffers, one per channel, may be NULL
+                 * @param samples number of samples to process
+                 * @param blocks list of block sizes
+                 * @param count number of elements in the list of block sizes
+                 */
+                void                process(float * const *out, const float * const *in,
+                                        const float * const *sc, float * const *gc,
+                                        size_t samples, const size_t *blocks, size_t count);
+
+            public:
+                inline plug::Module            *module()       { return pModule;       }
+                inline const meta::plugin_t    *metadata() const { return pMetadata;   }
+                inline size_t                   channels() const { return nChannels;   }
+                inline bool                     sidechain() const { return vSc[0] != NULL; }
+                ssize_t                         latency() const;
+        };
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* PRIVATE_TEST_SURGE_FILTER_HOST_H_ */
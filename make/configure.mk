@@ -27,6 +27,7 @@ PLUGINS                    := $(BASEDIR)/plugins.mk
 TEST                       := 0
 DEBUG                      := 0
 PROFILE                    := 0
+INSTRUMENT                 := 0
 TRACE                      := 0
 
 # Configure system settings
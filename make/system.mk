@@ -218,6 +218,7 @@ COMMON_VARS = \
 	HOST_ARCHITECTURE_FAMILY \
 	HOST_ARCHITECTURE_CFLAGS \
 	INSTALL_HEADERS \
+	INSTRUMENT \
 	LIBRARY_EXT \
 	LIBRARY_PREFIX \
 	PKGCONFIG_EXT \
@@ -245,6 +246,7 @@ sysvars:
 	echo "  EXPORT_SYMBOLS            make export symbols visible" 
 	echo "  FEATURES                  list of features enabled in the build"
 	echo "  INSTALL_HEADERS           install headers (enabled by default)"
+	echo "  INSTRUMENT                build with per-stage CPU cycle counters of plugins"
 	echo "  LIBRARY_EXT               file extension for library files"
 	echo "  LIBRARY_PREFIX            prefix used for library file"
 	echo "  PKGCONFIG_EXT             file extension for pkgconfig files"
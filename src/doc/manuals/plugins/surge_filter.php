@@ -1,12 +1,13 @@
 <?php
 	plugin_header();
 	
-	$m      =   ($PAGE == 'surge_filter_mono') ? 'm' : (
-	            ($PAGE == 'surge_filter_stereo') ? 's' : null
+	$m      =   (strpos($PAGE, '_mono') > 0) ? 'm' : (
+	            (strpos($PAGE, '_stereo') > 0) ? 's' : null
 	            );
 	$c      =   ($m == 'm') ? 'mono' : (
 	            ($m == 's') ? 'stereo' : null
 	            );
+	$sc     =   (strpos($PAGE, 'sc_') === 0);
 ?>
 
 <p>
@@ -45,12 +46,33 @@
 	<b>Fade-Out delay</b> time after the fade-out completes. This also saves plugin from issuing accidental
 	fade-in events which can be caused by oscillations of the falling down RMS envelope. 
 </p>
+<?php if ($sc) { ?>
+<p>
+	The sidechain version of the plugin computes the RMS envelope from the external sidechain
+	input instead of the main input. The fade-in and fade-out decision is made once for the
+	sidechain signal and then applied to all main channels. This allows to gate many channels
+	by the single key signal, for example by the master bus or by the dedicated signal which
+	indicates that the audio stream is running. The <b>Input</b> gain is applied both to the
+	main and to the sidechain signal.
+</p>
+<p>
+	Additionally, the sidechain version of the plugin provides the <b>gain curve</b> audio output
+	for each channel. This output contains the gain applied to the signal by the plugin in range
+	from 0 to 1 and is aligned with the audio output of the plugin. It can be used by other processors
+	to apply the same fade-in and fade-out without running their own detectors.
+</p>
+<?php } ?>
 <b>Controls below the graph:</b>
 <ul>
 	<li><b>Input</b> - enables drawing of the input signal on the graph.</li>
 	<li><b>Output</b> - enables drawing of the output signal on the graph.</li>
 	<li><b>Envelope</b> - enables drawing of the RMS envelope signal on the graph.</li>
 	<li><b>Gain</b> - enables drawing of the gain applied to the input signal on the graph.</li>
+	<?php if ($m == 's') { ?>
+	<li><b>Link</b> - links the channels: the fade-in and fade-out decision is made for the maximum of both
+	channels and applied to both channels simultaneously. If the link is disabled, each channel performs
+	fade-in and fade-out independently, which is useful for stereo pairs that carry independent mono streams.</li>
+	<?php } ?>
 </ul>
 <b>Main controls:</b>
 <ul>
@@ -84,4 +106,11 @@
     	<li><b>Delay</b> - The protection time to not to trigger accidental fade-out event</li>
 	</ul>
 	<li><b>Output</b> - the additional gain applied to the output signal of the plugin.</li>
+	<li><b>Control rate</b> - enables detection of fade-in and fade-out events at the control rate which is
+	32 times lower than the sample rate. This reduces the CPU usage but fade-in and fade-out events are detected
+	with the precision of 32 samples and the fade curves are linearly interpolated between control points.
+	In this mode the latency of the plugin is rounded up to the multiple of 32 samples and then increased by
+	32 samples more. Switching the detection rate changes the latency of the plugin: the new detector is
+	warmed up for the <b>RMS</b> time plus all fade and delay times, and the higher latency of both modes is
+	used until the switch is complete.</li>
 </ul>
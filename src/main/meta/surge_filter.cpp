@@ -26,7 +26,7 @@
 
 #define LSP_PLUGINS_SURGE_FILTER_VERSION_MAJOR       1
 #define LSP_PLUGINS_SURGE_FILTER_VERSION_MINOR       0
-#define LSP_PLUGINS_SURGE_FILTER_VERSION_MICRO       30
+#define LSP_PLUGINS_SURGE_FILTER_VERSION_MICRO       31
 
 #define LSP_PLUGINS_SURGE_FILTER_VERSION  \
     LSP_MODULE_VERSION( \
@@ -68,22 +68,41 @@ namespace lsp
             AMP_GAIN("output", "Output gain", "Output gain", 1.0f, GAIN_AMP_P_24_DB), \
             MESH("ig", "Input signal graph", channels+1, surge_filter_metadata::MESH_POINTS + 2), \
             MESH("og", "Output signal graph", channels+1, surge_filter_metadata::MESH_POINTS), \
-            MESH("grg", "Gain reduction graph", 2, surge_filter_metadata::MESH_POINTS + 4), \
-            MESH("eg", "Envelope graph", 2, surge_filter_metadata::MESH_POINTS), \
+            MESH("grg", "Gain reduction graph", channels+1, surge_filter_metadata::MESH_POINTS + 4), \
+            MESH("eg", "Envelope graph", channels+1, surge_filter_metadata::MESH_POINTS), \
             SWITCH("grv", "Gain reduction visibility", "Show reduct", 1.0f), \
             SWITCH("ev", "Envelope visibility", "Show env", 1.0f), \
             METER_GAIN("grm", "Gain reduction meter", GAIN_AMP_P_24_DB), \
             METER_GAIN("em", "Envelope meter", GAIN_AMP_P_24_DB)
 
+        #define SURGE_FILTER_CHANNEL(id, label, alias) \
+            SWITCH("igv" id, "Input graph visibility" label, "Show in" alias, 1.0f), \
+            SWITCH("ogv" id, "Output graph visibility" label, "Show out" alias, 1.0f), \
+            METER_GAIN("ilm" id, "Input level meter" label, GAIN_AMP_P_24_DB), \
+            METER_GAIN("olm" id, "Output level meter" label, GAIN_AMP_P_24_DB)
+
+        #define SURGE_FILTER_STEREO_LINK \
+            SWITCH("link", "Stereo link", "Link", 1.0f), \
+            METER_GAIN("grm_l", "Gain reduction meter left", GAIN_AMP_P_24_DB), \
+            METER_GAIN("grm_r", "Gain reduction meter right", GAIN_AMP_P_24_DB), \
+            METER_GAIN("em_l", "Envelope meter left", GAIN_AMP_P_24_DB), \
+            METER_GAIN("em_r", "Envelope meter right", GAIN_AMP_P_24_DB)
+
+        #define SURGE_FILTER_CONTROL_RATE \
+            SWITCH("crate", "Control-rate detection", "Ctl rate", 0.0f)
+
+        #define SURGE_FILTER_TRANSITIONS \
+            STREAM("tr", "Filter transitions", surge_filter_metadata::TRANSITION_FIELDS, \
+                surge_filter_metadata::TRANSITION_FRAMES, surge_filter_metadata::TRANSITION_CAPACITY)
+
         static const port_t surge_filter_mono_ports[] =
         {
             PORTS_MONO_PLUGIN,
             BYPASS,
             SURGE_FILTER_COMMON(1),
-            SWITCH("igv", "Input graph visibility", "Show in", 1.0f),
-            SWITCH("ogv", "Output graph visibility", "Show out", 1.0f),
-            METER_GAIN("ilm", "Input level meter", GAIN_AMP_P_24_DB),
-            METER_GAIN("olm", "Output level meter", GAIN_AMP_P_24_DB),
+            SURGE_FILTER_CHANNEL("", "", ""),
+            SURGE_FILTER_CONTROL_RATE,
+            SURGE_FILTER_TRANSITIONS,
 
             PORTS_END
         };
@@ -93,14 +112,42 @@ namespace lsp
             PORTS_STEREO_PLUGIN,
             BYPASS,
             SURGE_FILTER_COMMON(2),
-            SWITCH("igv_l", "Input graph visibility left", "Show in L", 1.0f),
-            SWITCH("ogv_l", "Output graph visibility left", "Show out L", 1.0f),
-            METER_GAIN("ilm_l", "Input level meter left", GAIN_AMP_P_24_DB),
-            METER_GAIN("olm_l", "Output level meter left", GAIN_AMP_P_24_DB),
-            SWITCH("igv_r", "Input graph visibility right", "Show in R", 1.0f),
-            SWITCH("ogv_r", "Output graph visibility right", "Show out R", 1.0f),
-            METER_GAIN("ilm_r", "Input level meter right", GAIN_AMP_P_24_DB),
-            METER_GAIN("olm_r", "Output level meter right", GAIN_AMP_P_24_DB),
+            SURGE_FILTER_CHANNEL("_l", " left", " L"),
+            SURGE_FILTER_CHANNEL("_r", " right", " R"),
+            SURGE_FILTER_STEREO_LINK,
+            SURGE_FILTER_CONTROL_RATE,
+            SURGE_FILTER_TRANSITIONS,
+
+            PORTS_END
+        };
+
+        static const port_t sc_surge_filter_mono_ports[] =
+        {
+            PORTS_MONO_PLUGIN,
+            PORTS_MONO_SIDECHAIN,
+            AUDIO_OUTPUT("gc", "Gain curve output"),
+            BYPASS,
+            SURGE_FILTER_COMMON(1),
+            SURGE_FILTER_CHANNEL("", "", ""),
+            SURGE_FILTER_CONTROL_RATE,
+            SURGE_FILTER_TRANSITIONS,
+
+            PORTS_END
+        };
+
+        static const port_t sc_surge_filter_stereo_ports[] =
+        {
+            PORTS_STEREO_PLUGIN,
+            PORTS_STEREO_SIDECHAIN,
+            AUDIO_OUTPUT("gc_l", "Gain curve output left"),
+            AUDIO_OUTPUT("gc_r", "Gain curve output right"),
+            BYPASS,
+            SURGE_FILTER_COMMON(2),
+            SURGE_FILTER_CHANNEL("_l", " left", " L"),
+            SURGE_FILTER_CHANNEL("_r", " right", " R"),
+            SURGE_FILTER_STEREO_LINK,
+            SURGE_FILTER_CONTROL_RATE,
+            SURGE_FILTER_TRANSITIONS,
 
             PORTS_END
         };
@@ -178,5 +225,69 @@ namespace lsp
         };
         LSP_REGISTER_METADATA(surge_filter_stereo);
 
+        const meta::plugin_t sc_surge_filter_mono =
+        {
+            "Sidechain-Sprungfilter Mono",
+            "Sidechain Surge Filter Mono",
+            "SC Surge Filter Mono",
+            "SCSF1M",
+            &developers::v_sadovnikov,
+            "sc_surge_filter_mono",
+            {
+                LSP_LV2_URI("sc_surge_filter_mono"),
+                LSP_LV2UI_URI("sc_surge_filter_mono"),
+                "sfsm",
+                LSP_VST3_UID("scsf1m  sfsm"),
+                LSP_VST3UI_UID("scsf1m  sfsm"),
+                0,
+                NULL,
+                LSP_CLAP_URI("sc_surge_filter_mono"),
+                LSP_GST_UID("sc_surge_filter_mono"),
+            },
+            LSP_PLUGINS_SURGE_FILTER_VERSION,
+            plugin_classes,
+            clap_features_mono,
+            E_INLINE_DISPLAY | E_DUMP_STATE,
+            sc_surge_filter_mono_ports,
+            "plugins/util/surge_filter.xml",
+            NULL,
+            mono_plugin_sidechain_port_groups,
+            &surge_filter_bundle,
+            2
+        };
+        LSP_REGISTER_METADATA(sc_surge_filter_mono);
+
+        const meta::plugin_t sc_surge_filter_stereo =
+        {
+            "Sidechain-Sprungfilter Stereo",
+            "Sidechain Surge Filter Stereo",
+            "SC Surge Filter Stereo",
+            "SCSF1S",
+            &developers::v_sadovnikov,
+            "sc_surge_filter_stereo",
+            {
+                LSP_LV2_URI("sc_surge_filter_stereo"),
+                LSP_LV2UI_URI("sc_surge_filter_stereo"),
+                "sfss",
+                LSP_VST3_UID("scsf1s  sfss"),
+                LSP_VST3UI_UID("scsf1s  sfss"),
+                0,
+                NULL,
+                LSP_CLAP_URI("sc_surge_filter_stereo"),
+                LSP_GST_UID("sc_surge_filter_stereo"),
+            },
+            LSP_PLUGINS_SURGE_FILTER_VERSION,
+            plugin_classes,
+            clap_features_stereo,
+            E_INLINE_DISPLAY | E_DUMP_STATE,
+            sc_surge_filter_stereo_ports,
+            "plugins/util/surge_filter.xml",
+            NULL,
+            stereo_plugin_sidechain_port_groups,
+            &surge_filter_bundle,
+            1
+        };
+        LSP_REGISTER_METADATA(sc_surge_filter_stereo);
+
     } /* namespace meta */
 } /* namespace lsp */
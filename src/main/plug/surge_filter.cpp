@@ -20,6 +20,7 @@
  */
 
 #include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/common/debug.h>
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/dsp-units/units.h>
@@ -29,43 +30,199 @@
 
 #include <private/plugins/surge_filter.h>
 
-#define BUFFER_SIZE     0x1000
+#ifdef LSP_INSTRUMENT
+    #if defined(ARCH_X86)
+        #include <x86intrin.h>
+    #else
+        #include <time.h>
+    #endif
+#endif /* LSP_INSTRUMENT */
+
+/* The size of processing block: all temporary buffers touched by one processing
+ * iteration of the stereo instance should fit into the L1 data cache, so the
+ * multiple passes over the block do not go to the main memory.
+ */
+#define BUFFER_SIZE     0x400
+
+/* The time period after the last inline display draw request while the inline display
+ * is considered to be shown by the host, in seconds.
+ */
+#define IDISPLAY_TIMEOUT    1.0f
+
+/* The capacity of the gate transition event log, should be power of 2 */
+#define TRANSITIONS_MAX     0x100
+
+/* The number of transition events transposed at once for the output to the stream */
+#define TRANSITIONS_CHUNK   0x20
+
+/* The size of chunk used to scan the input signal for digital silence */
+#define SILENCE_SCAN_SIZE   0x40
+
+/* The decimation factor of control-rate detection. Fade-in and fade-out events are
+ * detected with the precision of one control period (0.67 ms at 48 kHz), the gain
+ * curve is linearly interpolated between control points which adds one control
+ * period to the latency.
+ */
+#define CONTROL_DECIMATION  0x20
+
+/* The time of cross-fade between the gain curves of detectors when the detection rate is switched */
+#define CONTROL_XFADE_TIME  5.0f
+
+/* The time of cross-fade between the dry and the processed signal on bypass switch */
+#define BYPASS_XFADE_TIME   5.0f
+
+/* Flag of the snapshot that has been published but not consumed by the inline display yet */
+#define SNAPSHOT_DIRTY      0x4
+#define SNAPSHOT_INDEX      0x3
+
+/* Alignment of the per-instance data, the state of channels starts at the cache line boundary */
+#define CACHE_LINE_ALIGN    0x40
+
+/* Profiling of processing stages, enabled with INSTRUMENT=1 build option */
+#ifdef LSP_INSTRUMENT
+    #define PROFILE_BEGIN()             wsize_t prof_time = profile_clock()
+    #define PROFILE_STAGE(stage)        prof_time = profile_stage(stage, prof_time)
+#else
+    #define PROFILE_BEGIN()
+    #define PROFILE_STAGE(stage)
+#endif /* LSP_INSTRUMENT */
 
 namespace lsp
 {
     namespace plugins
     {
+        // Graphs stored in the inline display snapshot for each channel
+        enum snapshot_graph_t
+        {
+            SG_IN,
+            SG_OUT,
+            SG_ENV,
+            SG_GAIN,
+
+            SG_TOTAL
+        };
+
         //-------------------------------------------------------------------------
         // Plugin factory
+        typedef struct plugin_settings_t
+        {
+            const meta::plugin_t   *metadata;
+            bool                    sc;
+            uint8_t                 channels;
+        } plugin_settings_t;
+
         static const meta::plugin_t *plugins[] =
         {
             &meta::surge_filter_mono,
-            &meta::surge_filter_stereo
+            &meta::surge_filter_stereo,
+            &meta::sc_surge_filter_mono,
+            &meta::sc_surge_filter_stereo
+        };
+
+        static const plugin_settings_t plugin_settings[] =
+        {
+            { &meta::surge_filter_mono,         false,  1   },
+            { &meta::surge_filter_stereo,       false,  2   },
+            { &meta::sc_surge_filter_mono,      true,   1   },
+            { &meta::sc_surge_filter_stereo,    true,   2   },
+
+            { NULL, false, 0 }
         };
 
         static plug::Module *plugin_factory(const meta::plugin_t *meta)
         {
-            return new surge_filter(meta, (meta == &meta::surge_filter_stereo) ? 2 : 1);
+            for (const plugin_settings_t *s = plugin_settings; s->metadata != NULL; ++s)
+            {
+                if (s->metadata != meta)
+                    continue;
+
+                // Processing is specialized for mono and stereo only
+                if ((s->channels < 1) || (s->channels > meta::surge_filter_metadata::CHANNELS_MAX))
+                {
+                    lsp_warn("Unsupported number of channels %d for plugin %s", int(s->channels), meta->uid);
+                    return NULL;
+                }
+                return new surge_filter(s->metadata, s->sc, s->channels);
+            }
+            return NULL;
         }
 
-        static plug::Factory factory(plugin_factory, plugins, 2);
+        static plug::Factory factory(plugin_factory, plugins, sizeof(plugins) / sizeof(plugins[0]));
 
         //-------------------------------------------------------------------------
-        surge_filter::surge_filter(const meta::plugin_t *metadata, size_t channels): plug::Module(metadata)
+        surge_filter::surge_filter(const meta::plugin_t *metadata, bool sc, size_t channels): plug::Module(metadata)
         {
             nChannels       = channels;
             vChannels       = NULL;
-            vBuffer         = NULL;
-            vEnv            = NULL;
-            vTimePoints     = NULL;
-            vIDisplay       = NULL;
             fGainIn         = 1.0f;
             fGainOut        = 1.0f;
+            bSidechain      = sc;
+            bLink           = true;
+            nLinkSwitch     = 0;
+            bControlRate    = false;
+            bCtlDelayed     = false;
+            nGainDelay      = 0;
+            nCtlSwitch      = 0;
+            nCtlXFade       = 1;
+            bMetering       = false;
+            bSleep          = false;
+            nSilence        = 0;
+            nSleepThresh    = 0;
+            nSleepTime      = 0;
+            nPosition       = 0;
+            vTransitions    = NULL;
+            nTrHead         = 0;
+            nTrTail         = 0;
+            nTrLost         = 0;
+
+            vMeters         = NULL;
+            vTimePoints     = NULL;
+            nDelayCap       = 0;
+            invalidate_settings();
+        #ifdef LSP_INSTRUMENT
+            for (size_t i=0; i<PS_TOTAL; ++i)
+            {
+                sProfile.vTotal[i]      = 0;
+                sProfile.vPeak[i]       = 0;
+                sIDProfile.vTotal[i]    = 0;
+                sIDProfile.vPeak[i]     = 0;
+                vProfileCall[i]         = 0;
+            }
+            sProfile.nSeq   = 0;
+            sProfile.nCalls = 0;
+            sIDProfile.nSeq = 0;
+            sIDProfile.nCalls = 0;
+        #endif /* LSP_INSTRUMENT */
             bGainVisible    = false;
             bEnvVisible     = false;
+            bMeterSync      = true;
+            bUISync         = false;
+            nIDisplayReq    = 0;
+            nIDisplayAck    = 0;
+            nIDisplayTimeout= 0;
+            for (size_t i=0; i<3; ++i)
+            {
+                snapshot_t *s   = &vSnapshots[i];
+                s->vData        = NULL;
+                s->nDetectors   = 0;
+                for (size_t j=0; j<meta::surge_filter_metadata::CHANNELS_MAX; ++j)
+                {
+                    s->vInVisible[j]    = false;
+                    s->vOutVisible[j]   = false;
+                }
+                s->bBypass      = false;
+                s->bEnvVisible  = false;
+                s->bGainVisible = false;
+            }
+            nSnapMiddle     = 1;
+            nSnapBack       = 0;
+            nSnapFront      = 2;
             pData           = NULL;
             pIDisplay       = NULL;
 
+            // Select the processing routine specialized for the number of channels
+            pProcessBlocks  = (nChannels > 1) ? &surge_filter::process_blocks<2> : &surge_filter::process_blocks<1>;
+
             pModeIn         = NULL;
             pModeOut        = NULL;
             pGainIn         = NULL;
@@ -87,6 +244,9 @@ namespace lsp
             pEnvVisible     = NULL;
             pGainMeter      = NULL;
             pEnvMeter       = NULL;
+            pLink           = NULL;
+            pControlRate    = NULL;
+            pTransitions    = NULL;
         }
 
         surge_filter::~surge_filter()
@@ -98,39 +258,100 @@ namespace lsp
         {
             plug::Module::init(wrapper, ports);
 
-            // Allocate buffers
+            // Allocate all the data of the instance as a single chunk: the state of channels
+            // first, then processing buffers, then the data used only for metering
             size_t meshbuf      = align_size(meta::surge_filter_metadata::MESH_POINTS, DEFAULT_ALIGN);
-            size_t to_alloc     = 2*BUFFER_SIZE + nChannels * BUFFER_SIZE + meshbuf*2;
-            float *bufs         = alloc_aligned<float>(pData, to_alloc);
+            size_t szof_chan    = align_size(nChannels * sizeof(channel_t), CACHE_LINE_ALIGN);
+            size_t szof_bufs    = nChannels * BUFFER_SIZE * 4 * sizeof(float);
+            size_t szof_trans   = align_size(TRANSITIONS_MAX * sizeof(transition_t), CACHE_LINE_ALIGN);
+            size_t szof_meters  = align_size(nChannels * sizeof(meter_t), CACHE_LINE_ALIGN);
+            size_t szof_points  = meshbuf * sizeof(float);
+            size_t szof_snap    = nChannels * SG_TOTAL * meshbuf * sizeof(float);
+            size_t to_alloc     =
+                szof_chan +
+                szof_bufs +
+                szof_trans +
+                szof_meters +
+                szof_points +
+                szof_snap * 3;
+
+            uint8_t *bufs       = alloc_aligned<uint8_t>(pData, to_alloc, CACHE_LINE_ALIGN);
             if (bufs == NULL)
                 return;
 
-            // Allocate channels
-            vChannels       = new channel_t[nChannels];
-            if (vChannels == NULL)
-                return;
-            vBuffer         = advance_ptr_bytes<float>(bufs, BUFFER_SIZE * sizeof(float));
-            vEnv            = advance_ptr_bytes<float>(bufs, BUFFER_SIZE * sizeof(float));
-            vTimePoints     = advance_ptr_bytes<float>(bufs, meshbuf * sizeof(float));
-            vIDisplay       = advance_ptr_bytes<float>(bufs, meshbuf * sizeof(float));
+            vChannels           = advance_ptr_bytes<channel_t>(bufs, szof_chan);
+            uint8_t *chbufs     = advance_ptr_bytes<uint8_t>(bufs, szof_bufs);
+            vTransitions        = advance_ptr_bytes<transition_t>(bufs, szof_trans);
+            vMeters             = advance_ptr_bytes<meter_t>(bufs, szof_meters);
+            vTimePoints         = advance_ptr_bytes<float>(bufs, szof_points);
+            for (size_t i=0; i<3; ++i)
+            {
+                vSnapshots[i].vData = advance_ptr_bytes<float>(bufs, szof_snap);
+                dsp::fill_zero(vSnapshots[i].vData, szof_snap / sizeof(float));
+            }
 
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
+                meter_t *m      = &vMeters[i];
 
                 c->sBypass.construct();
+                c->sDelay.construct();
+                c->sGainDelay.construct();
+                c->sEnvDelay.construct();
+                c->sDepopper.construct();
+                c->sCtlDepopper.construct();
+                m->sIn.construct();
+                m->sOut.construct();
+                m->sGain.construct();
+                m->sEnv.construct();
+
+                // The size of meter graphs does not depend on the sample rate
+                m->sIn.init(meta::surge_filter_metadata::MESH_POINTS, 1);
+                m->sOut.init(meta::surge_filter_metadata::MESH_POINTS, 1);
+                m->sGain.init(meta::surge_filter_metadata::MESH_POINTS, 1);
+                m->sEnv.init(meta::surge_filter_metadata::MESH_POINTS, 1);
+                m->sGain.set_method(dspu::MM_ABS_MINIMUM);
 
                 c->vIn          = NULL;
                 c->vOut         = NULL;
-                c->vBuffer      = advance_ptr_bytes<float>(bufs, BUFFER_SIZE * sizeof(float));
-                c->bInVisible   = true;
-                c->bOutVisible  = true;
+                c->vSc          = NULL;
+                c->vGc          = NULL;
+                c->vBuffer      = advance_ptr_bytes<float>(chbufs, BUFFER_SIZE * sizeof(float));
+                c->vGain        = advance_ptr_bytes<float>(chbufs, BUFFER_SIZE * sizeof(float));
+                c->vEnv         = advance_ptr_bytes<float>(chbufs, BUFFER_SIZE * sizeof(float));
+                c->vTemp        = advance_ptr_bytes<float>(chbufs, BUFFER_SIZE * sizeof(float));
+                c->fGainMin     = 0.0f;
+                c->fGainMax     = 0.0f;
+                c->fLastGain    = 0.0f;
+                c->fLastEnv     = 0.0f;
+                c->fCtlSum      = 0.0f;
+                c->fCtlPrev     = 0.0f;
+                c->fCtlLast     = 0.0f;
+                c->fCtlEnvPrev  = 0.0f;
+                c->fCtlEnv      = 0.0f;
+                c->nCtlPos      = 0;
+
+                c->pIn          = NULL;
+                c->pOut         = NULL;
+                c->pSc          = NULL;
+                c->pGc          = NULL;
+
+                m->fInLevel     = 0.0f;
+                m->fOutLevel    = 0.0f;
+                m->fGainLevel   = GAIN_AMP_0_DB;
+                m->fEnvLevel    = 0.0f;
+                m->bInVisible   = true;
+                m->bOutVisible  = true;
+
+                m->pInVisible   = NULL;
+                m->pOutVisible  = NULL;
+                m->pMeterIn     = NULL;
+                m->pMeterOut    = NULL;
+                m->pGainMeter   = NULL;
+                m->pEnvMeter    = NULL;
             }
 
-            // Initialize de-popper
-            sDepopper.construct();
-            sGain.set_method(dspu::MM_ABS_MINIMUM);
-
             // Bind ports
             lsp_trace("Binding ports");
             size_t port_id      = 0;
@@ -143,6 +364,15 @@ namespace lsp
             for (size_t i=0; i<nChannels; ++i)
                 BIND_PORT(vChannels[i].pOut);
 
+            // Bind sidechain audio ports and gain curve outputs
+            if (bSidechain)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                    BIND_PORT(vChannels[i].pSc);
+                for (size_t i=0; i<nChannels; ++i)
+                    BIND_PORT(vChannels[i].pGc);
+            }
+
             // Bind control ports
             BIND_PORT(pBypass);
             BIND_PORT(pModeIn);
@@ -169,13 +399,25 @@ namespace lsp
             // Bind custom channel ports
             for (size_t i=0; i<nChannels; ++i)
             {
-                channel_t *c    = &vChannels[i];
+                meter_t *m      = &vMeters[i];
+
+                BIND_PORT(m->pInVisible);
+                BIND_PORT(m->pOutVisible);
+                BIND_PORT(m->pMeterIn);
+                BIND_PORT(m->pMeterOut);
+            }
 
-                BIND_PORT(c->pInVisible);
-                BIND_PORT(c->pOutVisible);
-                BIND_PORT(c->pMeterIn);
-                BIND_PORT(c->pMeterOut);
+            // Bind stereo link ports
+            if (nChannels > 1)
+            {
+                BIND_PORT(pLink);
+                for (size_t i=0; i<nChannels; ++i)
+                    BIND_PORT(vMeters[i].pGainMeter);
+                for (size_t i=0; i<nChannels; ++i)
+                    BIND_PORT(vMeters[i].pEnvMeter);
             }
+            BIND_PORT(pControlRate);
+            BIND_PORT(pTransitions);
 
             // Initialize time points
             float delta     = meta::surge_filter_metadata::MESH_TIME / (meta::surge_filter_metadata::MESH_POINTS - 1);
@@ -191,21 +433,37 @@ namespace lsp
 
         void surge_filter::do_destroy()
         {
-            // Drop all channels
+            // Drop all channels, the memory of channels is a part of the allocated data
             if (vChannels != NULL)
             {
                 for (size_t i=0; i<nChannels; ++i)
                 {
                     channel_t *c    = &vChannels[i];
+                    c->sBypass.destroy();
                     c->sDelay.destroy();
-                    c->sDryDelay.destroy();
-                    c->sIn.destroy();
-                    c->sOut.destroy();
+                    c->sGainDelay.destroy();
+                    c->sEnvDelay.destroy();
+                    c->sDepopper.destroy();
+                    c->sCtlDepopper.destroy();
                 }
+                vChannels   = NULL;
+            }
 
-                delete [] vChannels;
-                vChannels = NULL;
+            // Drop all meters
+            if (vMeters != NULL)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    meter_t *m      = &vMeters[i];
+                    m->sIn.destroy();
+                    m->sOut.destroy();
+                    m->sGain.destroy();
+                    m->sEnv.destroy();
+                }
+                vMeters     = NULL;
             }
+            vTransitions    = NULL;
+            vTimePoints     = NULL;
 
             // Drop buffers
             if (pData != NULL)
@@ -225,23 +483,91 @@ namespace lsp
         void surge_filter::update_sample_rate(long sr)
         {
             size_t samples_per_dot  = dspu::seconds_to_samples(sr, meta::surge_filter_metadata::MESH_TIME / meta::surge_filter_metadata::MESH_POINTS);
-            size_t max_delay        = dspu::millis_to_samples(sr, meta::surge_filter_metadata::FADEOUT_MAX);
+            size_t max_delay        = dspu::millis_to_samples(sr, meta::surge_filter_metadata::FADEOUT_MAX) + CONTROL_DECIMATION * 2;
 
-            sDepopper.init(sr, meta::surge_filter_metadata::FADEOUT_MAX, meta::surge_filter_metadata::RMS_MAX);
-            sGain.init(meta::surge_filter_metadata::MESH_POINTS, samples_per_dot);
-            sEnv.init(meta::surge_filter_metadata::MESH_POINTS, samples_per_dot);
             sActive.init(sr);
 
+            // Reset sleep state and force the reconfiguration. Detectors are re-initialized,
+            // so the pending switch of the detection rate is not needed anymore
+            nSilence        = 0;
+            bSleep          = false;
+            nLinkSwitch     = 0;
+            nCtlSwitch      = 0;
+            nCtlXFade       = lsp_max(dspu::millis_to_samples(sr, CONTROL_XFADE_TIME), size_t(1));
+            invalidate_settings();
+            reset_control_rate();
+
+            // Delay lines only grow, so switching back to a lower sample rate does not
+            // cause any memory reallocation
+            bool realloc        = max_delay > nDelayCap;
+            if (realloc)
+                nDelayCap           = max_delay;
+
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
 
-                c->sBypass.init(sr);
-                c->sDelay.init(max_delay);
-                c->sDryDelay.init(max_delay);
-                c->sIn.init(meta::surge_filter_metadata::MESH_POINTS, samples_per_dot);
-                c->sOut.init(meta::surge_filter_metadata::MESH_POINTS, samples_per_dot);
+                c->sBypass.init(sr, BYPASS_XFADE_TIME * 0.001f);
+                if (realloc)
+                {
+                    c->sDelay.init(nDelayCap);
+                    c->sGainDelay.init(nDelayCap);
+                    c->sEnvDelay.init(nDelayCap);
+                }
+                else
+                {
+                    c->sDelay.clear();
+                    c->sGainDelay.clear();
+                    c->sEnvDelay.clear();
+                }
+                c->sDepopper.init(sr, meta::surge_filter_metadata::FADEOUT_MAX, meta::surge_filter_metadata::RMS_MAX);
+                c->sCtlDepopper.init(sr / CONTROL_DECIMATION, meta::surge_filter_metadata::FADEOUT_MAX, meta::surge_filter_metadata::RMS_MAX);
+            }
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                meter_t *m      = &vMeters[i];
+
+                m->sIn.set_period(samples_per_dot);
+                m->sOut.set_period(samples_per_dot);
+                m->sGain.set_period(samples_per_dot);
+                m->sEnv.set_period(samples_per_dot);
             }
+
+            // The history of graphs has been computed for another sample rate
+            bMeterSync      = true;
+        }
+
+        void surge_filter::invalidate_settings()
+        {
+            fThreshOn       = -1.0f;
+            fThreshOff      = -1.0f;
+            fFadeIn         = -1.0f;
+            fFadeOut        = -1.0f;
+            fFadeInDelay    = -1.0f;
+            fFadeOutDelay   = -1.0f;
+            fRmsLen         = -1.0f;
+            nModeIn         = dspu::depopper_mode_t(-1);
+            nModeOut        = dspu::depopper_mode_t(-1);
+            nLatency        = size_t(-1);
+        }
+
+        static inline bool update_param(float *value, plug::IPort *port)
+        {
+            float v         = port->value();
+            if (v == *value)
+                return false;
+            *value          = v;
+            return true;
+        }
+
+        static inline bool update_mode(dspu::depopper_mode_t *mode, plug::IPort *port)
+        {
+            dspu::depopper_mode_t m = dspu::depopper_mode_t(port->value());
+            if (m == *mode)
+                return false;
+            *mode           = m;
+            return true;
         }
 
         void surge_filter::update_settings()
@@ -252,132 +578,974 @@ namespace lsp
             bGainVisible    = pGainVisible->value() >= 0.5f;
             bEnvVisible     = pEnvVisible->value() >= 0.5f;
 
-            // Change depopper state
-            sDepopper.set_fade_in_mode(dspu::depopper_mode_t(pModeIn->value()));
-            sDepopper.set_fade_in_threshold(pThreshOn->value());
-            sDepopper.set_fade_in_time(pFadeIn->value());
-            sDepopper.set_fade_in_delay(pFadeInDelay->value());
-            sDepopper.set_fade_out_mode(dspu::depopper_mode_t(pModeOut->value()));
-            sDepopper.set_fade_out_threshold(pThreshOff->value());
-            sDepopper.set_fade_out_time(pFadeOut->value());
-            sDepopper.set_fade_out_delay(pFadeOutDelay->value());
-            sDepopper.set_rms_length(pRmsLen->value());
-            sDepopper.reconfigure();
+            // Change depopper state only for parameters that have been changed
+            bool mode_in        = update_mode(&nModeIn, pModeIn);
+            bool thresh_on      = update_param(&fThreshOn, pThreshOn);
+            bool fade_in        = update_param(&fFadeIn, pFadeIn);
+            bool fade_in_delay  = update_param(&fFadeInDelay, pFadeInDelay);
+            bool mode_out       = update_mode(&nModeOut, pModeOut);
+            bool thresh_off     = update_param(&fThreshOff, pThreshOff);
+            bool fade_out       = update_param(&fFadeOut, pFadeOut);
+            bool fade_out_delay = update_param(&fFadeOutDelay, pFadeOutDelay);
+            bool rms_len        = update_param(&fRmsLen, pRmsLen);
+            bool reconfigure    =
+                mode_in || thresh_on || fade_in || fade_in_delay ||
+                mode_out || thresh_off || fade_out || fade_out_delay ||
+                rms_len;
+
+            if (reconfigure)
+            {
+                for (size_t i=0; i<nChannels*2; ++i)
+                {
+                    channel_t *c        = &vChannels[i >> 1];
+                    dspu::Depopper *dp  = (i & 1) ? &c->sCtlDepopper : &c->sDepopper;
+
+                    if (mode_in)
+                        dp->set_fade_in_mode(nModeIn);
+                    if (thresh_on)
+                        dp->set_fade_in_threshold(fThreshOn);
+                    if (fade_in)
+                        dp->set_fade_in_time(fFadeIn);
+                    if (fade_in_delay)
+                        dp->set_fade_in_delay(fFadeInDelay);
+                    if (mode_out)
+                        dp->set_fade_out_mode(nModeOut);
+                    if (thresh_off)
+                        dp->set_fade_out_threshold(fThreshOff);
+                    if (fade_out)
+                        dp->set_fade_out_time(fFadeOut);
+                    if (fade_out_delay)
+                        dp->set_fade_out_delay(fFadeOutDelay);
+                    if (rms_len)
+                        dp->set_rms_length(fRmsLen);
+
+                    dp->reconfigure();
+                }
+            }
+
+            // After initialization and sample rate change there is no state to hand over
+            // on switching the link or the detection rate, the latency is invalidated in this case
+            const bool fresh    = nLatency == size_t(-1);
+            const size_t settle = dspu::millis_to_samples(fSampleRate,
+                fRmsLen + fFadeIn + fFadeInDelay + fFadeOut + fFadeOutDelay);
+
+            // Update the stereo link. Only the detector of the first channel is running while channels
+            // are linked. On unlink, the detectors of other channels are fed with their own control
+            // signals until they settle down, then their gain curves are cross-faded with the common
+            // one. Graphs of the unlinked channels were not running, so metering needs to be synchronized
+            bool link       = (pLink == NULL) || (pLink->value() >= 0.5f);
+            if (fresh)
+            {
+                bLink           = link;
+                nLinkSwitch     = 0;
+            }
+            else if (link != ((nLinkSwitch > 0) ? false : bLink))
+            {
+                if (nLinkSwitch > 0)
+                    nLinkSwitch     = 0;
+                else if (link)
+                {
+                    bLink           = true;
+                    bMeterSync      = true;
+                }
+                else
+                {
+                    // Control periods of the woken up detectors are aligned with the first channel
+                    const channel_t *l  = &vChannels[0];
+                    for (size_t i=1; i<nChannels; ++i)
+                    {
+                        channel_t *c    = &vChannels[i];
+                        c->fCtlSum      = 0.0f;
+                        c->fCtlPrev     = l->fLastGain;
+                        c->fCtlLast     = l->fLastGain;
+                        c->nCtlPos      = l->nCtlPos;
+                    }
+                    nLinkSwitch     = nCtlXFade + settle;
+                }
+                bSleep          = false;
+            }
 
-            size_t latency  = sDepopper.latency();
+            // Switch the detection rate. The detector which was idle has an outdated state, so
+            // it is fed with the same control signal until it settles down, then its gain curve
+            // is cross-faded with the gain curve of the active detector. Switching back before
+            // the hand-over is complete cancels it, the active detector has never been stopped
+            bool crate      = (pControlRate->value() >= 0.5f);
+            bool target     = (nCtlSwitch > 0) ? !bControlRate : bControlRate;
+            bool handover   = false;
+            if (fresh)
+            {
+                bControlRate    = crate;
+                nCtlSwitch      = 0;
+            }
+            else if (crate != target)
+            {
+                if (nCtlSwitch > 0)
+                    nCtlSwitch      = 0;
+                else
+                {
+                    if (crate)
+                        reset_control_rate();
+                    nCtlSwitch      = nCtlXFade + settle;
+                    handover        = true;
+                }
+                bSleep          = false;
+            }
+
+            bool relatency  = update_latency();
+            if (handover)
+            {
+                // The gain curve of the incoming detector should pass the whole delay line
+                // before the cross-fade. The delay line of the active detector is primed
+                // if its gain curve becomes delayed
+                nCtlSwitch     += nGainDelay;
+                if ((nGainDelay > 0) && (bControlRate == bCtlDelayed))
+                    prime_gain_delay();
+            }
+
+            if ((reconfigure) || (relatency))
+            {
+                // Compute the amount of silence after which the state of the processor does
+                // not change anymore: the delay line and the RMS window contain only zeros,
+                // all pending fade transitions and protection delays and the bypass cross-fade
+                // have completed
+                nSleepThresh    = nLatency + dspu::millis_to_samples(fSampleRate,
+                    fRmsLen + fFadeIn + fFadeInDelay + fFadeOut + fFadeOutDelay + BYPASS_XFADE_TIME);
+                nSilence        = 0;
+                bSleep          = false;
+            }
 
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
+                if (c->sBypass.set_bypass(bypass))
+                {
+                    // The bypass cross-fade is not processed in the sleep mode
+                    nSilence        = 0;
+                    bSleep          = false;
+                }
+            }
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                meter_t *m      = &vMeters[i];
+                m->bInVisible   = m->pInVisible->value();
+                m->bOutVisible  = m->pOutVisible->value();
+            }
+        }
+
+        void surge_filter::reset_control_rate()
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->fCtlSum      = 0.0f;
+                c->fCtlPrev     = c->fLastGain;
+                c->fCtlLast     = c->fLastGain;
+                c->fCtlEnvPrev  = c->fCtlEnv;
+                c->nCtlPos      = 0;
+            }
+        }
 
-                c->sBypass.set_bypass(bypass);
+        bool surge_filter::update_latency()
+        {
+            // The latency is the latency of the active detector. While the detection rate is
+            // switched, the signal is delayed by the higher latency of both detectors and the
+            // gain curve of the detector with lower latency is delayed by the difference
+            const size_t sr_latency     = vChannels[0].sDepopper.latency();
+            const size_t ctl_latency    = (vChannels[0].sCtlDepopper.latency() + 1) * CONTROL_DECIMATION;
+            size_t latency, gain_delay;
+            if (nCtlSwitch > 0)
+            {
+                latency         = lsp_max(sr_latency, ctl_latency);
+                gain_delay      = latency - lsp_min(sr_latency, ctl_latency);
+            }
+            else
+            {
+                latency         = (bControlRate) ? ctl_latency : sr_latency;
+                gain_delay      = 0;
+            }
+
+            bCtlDelayed     = ctl_latency < sr_latency;
+            if ((latency == nLatency) && (gain_delay == nGainDelay))
+                return false;
+
+            nGainDelay      = gain_delay;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
                 c->sDelay.set_delay(latency);
-                c->sDryDelay.set_delay(latency);
-                c->bInVisible   = c->pInVisible->value();
-                c->bOutVisible  = c->pOutVisible->value();
+                c->sGainDelay.set_delay(gain_delay);
+                c->sEnvDelay.set_delay(gain_delay);
             }
 
-            // Report actual latency
+            if (latency == nLatency)
+                return false;
+            nLatency        = latency;
             set_latency(latency);
+
+            return true;
         }
 
-        void surge_filter::process(size_t samples)
+        void surge_filter::prime_gain_delay()
         {
-            // Bind ports
+            // The gain curve and the envelope did not pass the delay lines before, so the delay
+            // lines are filled with the last values to keep the gain curve and the envelope continuous
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
-                c->vIn          = c->pIn->buffer<float>();
-                c->vOut         = c->pOut->buffer<float>();
+                c->sGainDelay.clear();
+                c->sEnvDelay.clear();
+                for (size_t offset=0, n; offset < nGainDelay; offset += n)
+                {
+                    n               = lsp_min(nGainDelay - offset, size_t(BUFFER_SIZE));
+                    dsp::fill(c->vTemp, c->fLastGain, n);
+                    c->sGainDelay.process(c->vTemp, c->vTemp, n);
+                    dsp::fill(c->vTemp, c->fLastEnv, n);
+                    c->sEnvDelay.process(c->vTemp, c->vTemp, n);
+                }
+            }
+        }
+
+        void surge_filter::process_control_rate(channel_t *c, float *gain, float *env, size_t samples)
+        {
+            // The control signal is split into control periods. The RMS of each period is passed
+            // to the depopper operating at the control rate, so the RMS estimation over the whole
+            // window stays exact. The gain curve and the envelope are delayed by one control
+            // period and linearly interpolated between two last control points
+            const float k   = 1.0f / CONTROL_DECIMATION;
+
+            for (size_t offset=0, n; offset < samples; offset += n)
+            {
+                n               = lsp_min(samples - offset, size_t(CONTROL_DECIMATION - c->nCtlPos));
+                float *dst      = &gain[offset];
+                float delta     = (c->fCtlLast - c->fCtlPrev) * k;
+                float edelta    = (c->fCtlEnv - c->fCtlEnvPrev) * k;
+
+                c->fCtlSum     += dsp::h_sqr_sum(dst, n);
+                dsp::lramp_set1(dst, c->fCtlPrev + delta * c->nCtlPos, c->fCtlPrev + delta * (c->nCtlPos + n), n);
+                dsp::lramp_set1(&env[offset], c->fCtlEnvPrev + edelta * c->nCtlPos, c->fCtlEnvPrev + edelta * (c->nCtlPos + n), n);
+                c->nCtlPos     += n;
+
+                // Compute next control point
+                if (c->nCtlPos >= CONTROL_DECIMATION)
+                {
+                    float rms       = sqrtf(c->fCtlSum * k);
+                    c->fCtlPrev     = c->fCtlLast;
+                    c->fCtlEnvPrev  = c->fCtlEnv;
+                    c->sCtlDepopper.process(&c->fCtlEnv, &c->fCtlLast, &rms, 1);
+                    c->fCtlSum      = 0.0f;
+                    c->nCtlPos      = 0;
+                }
             }
+        }
+
+        void surge_filter::process_detector(channel_t *c, bool crate, float *gain, float *env, size_t samples)
+        {
+            if (crate)
+                process_control_rate(c, gain, env, samples);
+            else
+                c->sDepopper.process(env, gain, gain, samples);
+
+            // The envelope is delayed together with the gain curve, so transition events
+            // report the envelope at the same instant as the gain
+            if ((nGainDelay > 0) && (crate == bCtlDelayed))
+            {
+                c->sGainDelay.process(gain, gain, samples);
+                c->sEnvDelay.process(env, env, samples);
+            }
+        }
+
+        void surge_filter::crossfade_detectors(channel_t *c, size_t samples)
+        {
+            // The gain curve of the incoming detector is faded in during the last nCtlXFade
+            // samples of the switch, the block never crosses the end of the switch
+            if (nCtlSwitch > nCtlXFade + samples)
+                return;
+
+            const float k   = 1.0f / nCtlXFade;
+            for (size_t i=0; i<samples; ++i)
+            {
+                size_t left     = nCtlSwitch - i;
+                if (left <= nCtlXFade)
+                    c->vGain[i]    += (c->vTemp[i] - c->vGain[i]) * ((nCtlXFade - left + 1) * k);
+            }
+        }
+
+        void surge_filter::crossfade_link(size_t samples)
+        {
+            // Unlinked channels use the common gain curve until the last nCtlXFade samples
+            // of unlinking, then their own gain curves are faded in. The block never crosses
+            // the end of unlinking
+            const float *g  = vChannels[0].vGain;
+            const float k   = 1.0f / nCtlXFade;
+            for (size_t j=1; j<nChannels; ++j)
+            {
+                float *dst      = vChannels[j].vGain;
+                for (size_t i=0; i<samples; ++i)
+                {
+                    size_t left     = nLinkSwitch - i;
+                    dst[i]          = (left > nCtlXFade) ? g[i] : g[i] + (dst[i] - g[i]) * ((nCtlXFade - left + 1) * k);
+                }
+            }
+        }
+
+        void surge_filter::ui_activated()
+        {
+            // Force the metering state to be re-checked on the next process() call
+            bUISync         = true;
+        }
+
+        bool surge_filter::update_metering(size_t samples)
+        {
+            // Check that the host has recently requested the inline display for drawing
+            uatomic_t req       = atomic_load(&nIDisplayReq);
+            if (req != nIDisplayAck)
+            {
+                nIDisplayAck        = req;
+                nIDisplayTimeout    = dspu::seconds_to_samples(fSampleRate, IDISPLAY_TIMEOUT);
+            }
+            else
+                nIDisplayTimeout    = (nIDisplayTimeout > samples) ? nIDisplayTimeout - samples : 0;
+
+            // Enable metering only if there is at least one consumer of the metering data
+            bool metering       = (ui_active()) || (nIDisplayTimeout > 0);
+            if ((metering) && ((!bMetering) || (bUISync)))
+                bMeterSync          = true;
+
+            bMetering           = metering;
+            bUISync             = false;
+
+            return metering;
+        }
+
+        void surge_filter::sync_metering()
+        {
+            // The history of graphs is unknown since metering was off, reset it
+            // to the current state of the processor
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const channel_t *c  = &vChannels[i];
+                meter_t *m          = &vMeters[i];
+                m->sIn.fill(0.0f);
+                m->sOut.fill(0.0f);
+                m->sGain.fill(c->vGain[0]);
+                m->sEnv.fill(c->vEnv[0]);
+            }
+
+            bMeterSync      = false;
+        }
+
+    #ifdef LSP_INSTRUMENT
+        static const char *profile_stage_names[] =
+        {
+            "input_gain",
+            "input_meter",
+            "control",
+            "depopper",
+            "gain_meter",
+            "delay",
+            "bypass",
+            "output_meter",
+            "mesh",
+            "idisplay"
+        };
+
+        static inline wsize_t profile_clock()
+        {
+        #if defined(ARCH_X86)
+            return __rdtsc();
+        #else
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return wsize_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+        #endif
+        }
+
+        inline wsize_t surge_filter::profile_stage(size_t stage, wsize_t start)
+        {
+            wsize_t time        = profile_clock();
+            vProfileCall[stage]+= time - start;
+            return time;
+        }
+
+        void surge_filter::profile_update(profile_t *p, const wsize_t *cycles, size_t first, size_t count)
+        {
+            // The sequence number is odd while the counters are being updated
+            atomic_add(&p->nSeq, uatomic_t(1));
+            for (size_t i=first; i<first + count; ++i)
+            {
+                p->vTotal[i]       += cycles[i];
+                p->vPeak[i]         = lsp_max(p->vPeak[i], cycles[i]);
+            }
+            ++p->nCalls;
+            atomic_add(&p->nSeq, uatomic_t(1));
+        }
+
+        void surge_filter::profile_read(profile_t *dst, const profile_t *src)
+        {
+            uatomic_t seq;
+            do
+            {
+                seq                 = atomic_load(&src->nSeq);
+                for (size_t i=0; i<PS_TOTAL; ++i)
+                {
+                    dst->vTotal[i]      = src->vTotal[i];
+                    dst->vPeak[i]       = src->vPeak[i];
+                }
+                dst->nCalls         = src->nCalls;
+            } while ((seq & 1) || (seq != atomic_load(&src->nSeq)));
+            dst->nSeq           = seq;
+        }
+
+        void surge_filter::profile_commit()
+        {
+            // Counters of the inline display stage are owned by the inline display thread
+            profile_update(&sProfile, vProfileCall, 0, PS_IDISPLAY);
+            for (size_t i=0; i<PS_IDISPLAY; ++i)
+                vProfileCall[i]     = 0;
+        }
+    #endif /* LSP_INSTRUMENT */
+
+        void surge_filter::push_transition(size_t channel, size_t offset, bool open)
+        {
+            // Check that there is space in the ring buffer
+            uatomic_t head      = nTrHead;
+            uatomic_t tail      = atomic_load(&nTrTail);
+            if ((head - tail) >= TRANSITIONS_MAX)
+            {
+                atomic_add(&nTrLost, uatomic_t(1));
+                return;
+            }
+
+            // Emit the event
+            transition_t *t     = &vTransitions[head & (TRANSITIONS_MAX - 1)];
+            t->nPosition        = nPosition + offset;
+            t->fEnvelope        = vChannels[channel].vEnv[offset];
+            t->nDirection       = (open) ? TD_OPEN : TD_CLOSE;
+            t->nMode            = (open) ? nModeIn : nModeOut;
+            t->nChannel         = channel;
+
+            // Commit the event to the reader
+            atomic_store(&nTrHead, head + 1);
+
+            // Trigger the activity indicator
+            if (open)
+                sActive.blink();
+        }
+
+        void surge_filter::detect_transitions(size_t channel, size_t samples)
+        {
+            // Quick check that the whole block has the same state as the end of the previous one
+            const channel_t *c  = &vChannels[channel];
+            bool opened         = c->fLastGain > 0.0f;
+            if ((opened) ? c->fGainMin > 0.0f : c->fGainMax <= 0.0f)
+                return;
+
+            // Find all transitions between the closed and non-closed state
+            for (size_t i=0; i<samples; ++i)
+            {
+                if ((c->vGain[i] > 0.0f) == opened)
+                    continue;
+                opened          = !opened;
+                push_transition(channel, i, opened);
+            }
+        }
+
+        size_t surge_filter::read_transitions(transition_t *dst, size_t count)
+        {
+            uatomic_t tail      = nTrTail;
+            uatomic_t head      = atomic_load(&nTrHead);
+            size_t n            = lsp_min(size_t(head - tail), count);
+
+            for (size_t i=0; i<n; ++i)
+                dst[i]              = vTransitions[(tail + i) & (TRANSITIONS_MAX - 1)];
+
+            atomic_store(&nTrTail, uatomic_t(tail + n));
+            return n;
+        }
+
+        void surge_filter::output_transitions()
+        {
+            plug::stream_t *stream  = pTransitions->buffer<plug::stream_t>();
+            if (stream == NULL)
+                return;
+
+            // The processing thread is the only reader of the ring buffer when the stream is connected
+            uatomic_t tail      = nTrTail;
+            size_t count        = lsp_min(size_t(nTrHead - tail), meta::surge_filter_metadata::TRANSITION_CAPACITY);
+            if (count == 0)
+                return;
+
+            // Transpose events into the fields of the frame by small chunks
+            float fields[meta::surge_filter_metadata::TRANSITION_FIELDS][TRANSITIONS_CHUNK];
+            const double k      = 1.0 / fSampleRate;
+
+            stream->add_frame(count);
+            for (size_t offset=0, n; offset < count; offset += n)
+            {
+                n                   = lsp_min(count - offset, size_t(TRANSITIONS_CHUNK));
+                for (size_t i=0; i<n; ++i)
+                {
+                    const transition_t *t   = &vTransitions[(tail + offset + i) & (TRANSITIONS_MAX - 1)];
+                    fields[0][i]            = t->nPosition * k;
+                    fields[1][i]            = t->fEnvelope;
+                    fields[2][i]            = t->nDirection;
+                    fields[3][i]            = t->nMode;
+                    fields[4][i]            = t->nChannel;
+                }
+
+                for (size_t j=0; j<meta::surge_filter_metadata::TRANSITION_FIELDS; ++j)
+                    stream->write_frame(j, fields[j], offset, n);
+            }
+            stream->commit_frame();
+
+            atomic_store(&nTrTail, uatomic_t(tail + count));
+        }
+
+        static bool is_silent(const float *src, size_t count)
+        {
+            // Scan the data by small chunks to bail out early on non-silent signal
+            for (size_t n; count > 0; count -= n, src += n)
+            {
+                n = lsp_min(count, SILENCE_SCAN_SIZE);
+                if (dsp::abs_max(src, n) > 0.0f)
+                    return false;
+            }
+
+            return true;
+        }
+
+        template <size_t CHANNELS>
+        bool surge_filter::input_silent(size_t samples) const
+        {
+            const size_t channels   = CHANNELS;
+            for (size_t i=0; i<channels; ++i)
+            {
+                const channel_t *c  = &vChannels[i];
+                if (!is_silent(c->vIn, samples))
+                    return false;
+                if ((c->vSc != c->vIn) && (!is_silent(c->vSc, samples)))
+                    return false;
+            }
+            return true;
+        }
+
+        template <size_t CHANNELS>
+        void surge_filter::process_sleep(size_t samples, bool metering)
+        {
+            const size_t channels   = CHANNELS;
+            const size_t detectors  = (bLink) ? 1 : channels;
+            const float *zero       = vChannels[0].vBuffer;
+
+            // Feed graphs with silence to keep them running
+            if (metering)
+            {
+                if (bMeterSync)
+                    sync_metering();
+
+                dsp::fill_zero(vChannels[0].vBuffer, samples);
+                for (size_t i=0; i<channels; ++i)
+                {
+                    meter_t *m      = &vMeters[i];
+                    m->sIn.process(zero, samples);
+                    m->sOut.process(zero, samples);
+                }
+                for (size_t i=0; i<detectors; ++i)
+                {
+                    meter_t *m      = &vMeters[i];
+                    m->fGainLevel   = 0.0f;
+                    m->sGain.process(zero, samples);
+                    m->sEnv.process(zero, samples);
+                }
+            }
+
+            // Keep the phase of control periods, the skipped periods do not change the state
+            if (bControlRate)
+            {
+                for (size_t i=0; i<channels; ++i)
+                {
+                    channel_t *c    = &vChannels[i];
+                    c->nCtlPos      = (c->nCtlPos + samples) % CONTROL_DECIMATION;
+                }
+            }
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+
+                dsp::fill_zero(c->vOut, samples);
+                if (c->vGc != NULL)
+                    dsp::fill_zero(c->vGc, samples);
+
+                c->vIn         += samples;
+                c->vOut        += samples;
+                c->vSc         += samples;
+                if (c->vGc != NULL)
+                    c->vGc         += samples;
+            }
+
+            nSleepTime     += samples;
+            nPosition      += samples;
+        }
+
+        template <size_t CHANNELS>
+        void surge_filter::process_blocks(size_t samples, bool metering)
+        {
+            // The number of channels is a compile-time constant
+            const size_t channels   = CHANNELS;
 
             for (size_t nleft=samples; nleft > 0; )
             {
-                size_t to_process = (nleft > BUFFER_SIZE) ? BUFFER_SIZE : nleft;
+                // The block ends at the end of the detection rate switch and at the end of unlinking,
+                // so the latency and the link change at the same sample whatever the size of blocks is
+                size_t to_process = lsp_min(nleft, BUFFER_SIZE);
+                if (nCtlSwitch > 0)
+                    to_process      = lsp_min(to_process, nCtlSwitch);
+                if (nLinkSwitch > 0)
+                    to_process      = lsp_min(to_process, nLinkSwitch);
+
+                // In linked mode the first channel performs detection for all channels, the detectors
+                // of other channels are running only while channels are being unlinked
+                const size_t detectors  = (bLink) ? 1 : channels;
+                const size_t running    = ((bLink) && (nLinkSwitch == 0)) ? 1 : channels;
+
+                // Check that we can continue sleeping
+                if (bSleep)
+                {
+                    if (input_silent<CHANNELS>(to_process))
+                    {
+                        process_sleep<CHANNELS>(to_process, metering);
+                        nleft      -= to_process;
+                        continue;
+                    }
+
+                    // Wake up: all skipped samples were zero, so the state of the processor
+                    // is the same as if they were processed
+                    bSleep          = false;
+                    nSilence        = 0;
+                }
 
-                // Perform main processing
-                if (nChannels > 1)
+                // Apply input gain, process input metering and compute control signal
+                // while the data of each channel is still hot in the cache. In linked mode
+                // the control signal is the absolute maximum over all channels, it is
+                // accumulated so each channel block is read only once. The amplified input
+                // is needed only for metering, otherwise the input gain is applied to the
+                // control signal after all channels have been accumulated, which gives the
+                // same result since the gain is positive. This is the case for the external
+                // sidechain and for rendering without any UI or inline display shown
+                PROFILE_BEGIN();
+                for (size_t i=0; i<channels; ++i)
                 {
-                    // Apply input gain
-                    dsp::mul_k3(vChannels[0].vBuffer, vChannels[0].vIn, fGainIn, to_process);
-                    dsp::mul_k3(vChannels[1].vBuffer, vChannels[1].vIn, fGainIn, to_process);
+                    channel_t *c    = &vChannels[i];
 
-                    // Process input graph
-                    vChannels[0].sIn.process(vChannels[0].vBuffer, to_process);
-                    vChannels[1].sIn.process(vChannels[1].vBuffer, to_process);
+                    if (metering)
+                    {
+                        dsp::mul_k3(c->vBuffer, c->vIn, fGainIn, to_process);
+                        PROFILE_STAGE(PS_INPUT_GAIN);
+                        meter_t *m      = &vMeters[i];
+                        m->sIn.process(c->vBuffer, to_process);
+                        m->fInLevel     = lsp_max(m->fInLevel, dsp::abs_max(c->vBuffer, to_process));
+                        PROFILE_STAGE(PS_INPUT_METER);
+                    }
+
+                    const float *key    = (bSidechain) ? c->vSc : (metering) ? c->vBuffer : c->vIn;
+                    if ((i == 0) || (!bLink))
+                        dsp::abs2(c->vGain, key, to_process);
+                    else if (nLinkSwitch > 0)
+                    {
+                        dsp::abs2(c->vGain, key, to_process);
+                        dsp::pamax2(vChannels[0].vGain, c->vGain, to_process);
+                    }
+                    else
+                        dsp::pamax2(vChannels[0].vGain, key, to_process);
+                    PROFILE_STAGE(PS_CONTROL);
+                }
 
-                    // Apply meter values
-                    vChannels[0].pMeterIn->set_value(dsp::abs_max(vChannels[0].vBuffer, to_process));
-                    vChannels[1].pMeterIn->set_value(dsp::abs_max(vChannels[1].vBuffer, to_process));
+                // Check the input for digital silence before it gets overwritten by the output
+                bool silent     = true;
+                for (size_t i=0; i<running; ++i)
+                {
+                    channel_t *c    = &vChannels[i];
+                    if ((bSidechain) || (!metering))
+                        dsp::mul_k2(c->vGain, fGainIn, to_process);
+                    silent          = (silent) && (dsp::max(c->vGain, to_process) <= 0.0f);
+                }
+                silent          = (silent) && (input_silent<CHANNELS>(to_process));
+                PROFILE_STAGE(PS_CONTROL);
+
+                // Process the gain reduction control. In linked mode the gain of the first channel
+                // is applied to all channels
+                for (size_t i=0; i<running; ++i)
+                {
+                    channel_t *c    = &vChannels[i];
 
-                    // Compute control signal
-                    dsp::pamax3(vBuffer, vChannels[0].vBuffer, vChannels[1].vBuffer, to_process);
+                    if (nCtlSwitch > 0)
+                    {
+                        // The envelope of the incoming detector is not used until the hand-over is complete
+                        dsp::copy(c->vTemp, c->vGain, to_process);
+                        process_detector(c, !bControlRate, c->vTemp, c->vBuffer, to_process);
+                        process_detector(c, bControlRate, c->vGain, c->vEnv, to_process);
+                        crossfade_detectors(c, to_process);
+                    }
+                    else
+                        process_detector(c, bControlRate, c->vGain, c->vEnv, to_process);
                 }
-                else
+                if (nLinkSwitch > 0)
+                    crossfade_link(to_process);
+
+                bool closed     = true;
+                for (size_t i=0; i<running; ++i)
                 {
-                    // Apply input gain
-                    dsp::mul_k3(vChannels[0].vBuffer, vChannels[0].vIn, fGainIn, to_process);
+                    channel_t *c    = &vChannels[i];
+                    dsp::minmax(c->vGain, to_process, &c->fGainMin, &c->fGainMax);
+                    if (i < detectors)
+                        detect_transitions(i, to_process);
+                    c->fLastGain    = c->vGain[to_process - 1];
+                    c->fLastEnv     = c->vEnv[to_process - 1];
+                    closed          = (closed) && (c->fGainMax <= 0.0f);
+                }
 
-                    // Process input graph and meter
-                    vChannels[0].sIn.process(vChannels[0].vBuffer, to_process);
-                    vChannels[0].pMeterIn->set_value(dsp::abs_max(vChannels[0].vBuffer, to_process));
+                // Complete the switch of the detection rate
+                bool relatency  = false;
+                if (nCtlSwitch > 0)
+                {
+                    nCtlSwitch     -= to_process;
+                    if (nCtlSwitch == 0)
+                    {
+                        bControlRate    = !bControlRate;
+                        relatency       = true;
+                    }
+                    closed          = false;
+                }
 
-                    // Compute control signal
-                    dsp::abs2(vBuffer, vChannels[0].vBuffer, to_process);
+                // Complete unlinking of channels
+                if (nLinkSwitch > 0)
+                {
+                    nLinkSwitch    -= to_process;
+                    if (nLinkSwitch == 0)
+                    {
+                        bLink           = false;
+                        bMeterSync      = true;
+                    }
+                    closed          = false;
                 }
+                PROFILE_STAGE(PS_DEPOPPER);
 
-                // Process the gain reduction control
-                sDepopper.process(vEnv, vBuffer, vBuffer, to_process);
-                pGainMeter->set_value(dsp::abs_min(vBuffer, to_process));
-                pEnvMeter->set_value(dsp::abs_max(vEnv, to_process));
-                sGain.process(vBuffer, to_process);
-                sEnv.process(vEnv, to_process);
+                if (metering)
+                {
+                    if (bMeterSync)
+                        sync_metering();
+
+                    for (size_t i=0; i<detectors; ++i)
+                    {
+                        const channel_t *c  = &vChannels[i];
+                        meter_t *m          = &vMeters[i];
+
+                        m->fGainLevel   = lsp_min(m->fGainLevel, c->fGainMin);
+                        m->fEnvLevel    = lsp_max(m->fEnvLevel, dsp::abs_max(c->vEnv, to_process));
+                        m->sGain.process(c->vGain, to_process);
+                        m->sEnv.process(c->vEnv, to_process);
+                    }
+                    PROFILE_STAGE(PS_GAIN_METER);
+                }
 
                 // Apply reduction to the signal
-                for (size_t i=0; i<nChannels; ++i)
+                for (size_t i=0; i<channels; ++i)
                 {
                     channel_t *c    = &vChannels[i];
-
-                    // Apply delay to compensate latency and output gain
-                    c->sDelay.process(c->vBuffer, c->vBuffer, to_process);
-                    c->sDryDelay.process(c->vOut, c->vIn, to_process);
-                    dsp::fmmul_k3(c->vBuffer, vBuffer, fGainOut, to_process);
+                    const channel_t *d  = (running > 1) ? c : &vChannels[0];
+
+                    // Apply delay to compensate latency. The delay line stores the
+                    // original input signal which is used both as a dry signal and
+                    // as a source for the processed signal
+                    c->sDelay.process(c->vOut, c->vIn, to_process);
+                    PROFILE_STAGE(PS_DELAY);
+                    if (d->fGainMax <= 0.0f)
+                    {
+                        // Filter is closed
+                        dsp::fill_zero(c->vBuffer, to_process);
+                    }
+                    else if (d->fGainMin >= GAIN_AMP_0_DB)
+                    {
+                        // Filter is open, only input and output gain need to be applied
+                        dsp::mul_k3(c->vBuffer, c->vOut, fGainIn, to_process);
+                        if (fGainOut != GAIN_AMP_0_DB)
+                            dsp::mul_k2(c->vBuffer, fGainOut, to_process);
+                    }
+                    else
+                    {
+                        dsp::mul_k3(c->vBuffer, c->vOut, fGainIn, to_process);
+                        dsp::fmmul_k3(c->vBuffer, d->vGain, fGainOut, to_process);
+                    }
                     c->sBypass.process(c->vOut, c->vOut, c->vBuffer, to_process);
+                    PROFILE_STAGE(PS_BYPASS);
+
+                    // Output the gain curve, it is already aligned with the delayed signal
+                    if (c->vGc != NULL)
+                        dsp::copy(c->vGc, d->vGain, to_process);
 
                     // Process output graph and meter
-                    c->sOut.process(c->vBuffer, to_process);
-                    c->pMeterOut->set_value(dsp::abs_max(c->vBuffer, to_process));
+                    if (metering)
+                    {
+                        meter_t *m      = &vMeters[i];
+                        m->sOut.process(c->vBuffer, to_process);
+                        m->fOutLevel    = lsp_max(m->fOutLevel, dsp::abs_max(c->vBuffer, to_process));
+                        PROFILE_STAGE(PS_OUTPUT_METER);
+                    }
 
                     // Update pointers
                     c->vIn         += to_process;
                     c->vOut        += to_process;
+                    c->vSc         += to_process;
+                    if (c->vGc != NULL)
+                        c->vGc         += to_process;
                 }
+                nPosition      += to_process;
+
+                // The latency of the incoming detector is applied to the next block
+                if (relatency)
+                    update_latency();
+
+                // Enter the sleep mode if the processor state does not change on silence anymore
+                if (silent)
+                {
+                    nSilence       += to_process;
+                    if ((nSilence >= nSleepThresh) && (closed))
+                    {
+                        bool sleep      = true;
+                        for (size_t i=0; (sleep) && (i<running); ++i)
+                        {
+                            float env_min, env_max;
+                            dsp::minmax(vChannels[i].vEnv, to_process, &env_min, &env_max);
+                            sleep           = env_min >= env_max;
+                        }
+                        bSleep          = sleep;
+                    }
+                }
+                else
+                    nSilence        = 0;
 
                 // Update number of samples left
                 nleft      -= to_process;
             }
+        }
+
+        void surge_filter::process(size_t samples)
+        {
+            // Bind ports
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->vIn          = c->pIn->buffer<float>();
+                c->vOut         = c->pOut->buffer<float>();
+                c->vSc          = (c->pSc != NULL) ? c->pSc->buffer<float>() : c->vIn;
+                c->vGc          = (c->pGc != NULL) ? c->pGc->buffer<float>() : NULL;
+            }
+
+            // Reset peak values
+            bool metering       = update_metering(samples);
+            if (metering)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    meter_t *m      = &vMeters[i];
+                    m->fInLevel     = 0.0f;
+                    m->fOutLevel    = 0.0f;
+                    m->fGainLevel   = GAIN_AMP_0_DB;
+                    m->fEnvLevel    = 0.0f;
+                }
+            }
+
+            // Perform main processing
+            (this->*pProcessBlocks)(samples, metering);
+            pActive->set_value(sActive.process(samples));
+            output_transitions();
+
+            // Output metering data if there is a consumer
+            if (metering)
+            {
+                float gain_level    = GAIN_AMP_0_DB;
+                float env_level     = 0.0f;
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    const meter_t *m    = &vMeters[i];
+                    const meter_t *d    = (bLink) ? &vMeters[0] : m;
+
+                    m->pMeterIn->set_value(m->fInLevel);
+                    m->pMeterOut->set_value(m->fOutLevel);
+                    if (m->pGainMeter != NULL)
+                        m->pGainMeter->set_value(d->fGainLevel);
+                    if (m->pEnvMeter != NULL)
+                        m->pEnvMeter->set_value(d->fEnvLevel);
+
+                    gain_level          = lsp_min(gain_level, d->fGainLevel);
+                    env_level           = lsp_max(env_level, d->fEnvLevel);
+                }
+                pGainMeter->set_value(gain_level);
+                pEnvMeter->set_value(env_level);
+
+            #ifdef LSP_INSTRUMENT
+                wsize_t prof_time   = profile_clock();
+            #endif /* LSP_INSTRUMENT */
+                output_meshes();
+                if (nIDisplayTimeout > 0)
+                    publish_snapshot();
+            #ifdef LSP_INSTRUMENT
+                profile_stage(PS_MESH, prof_time);
+            #endif /* LSP_INSTRUMENT */
+            }
+
+            // Query inline display for draw. This should be done even if metering
+            // is off since it is the only way to know that inline display is shown
+            bool query_draw = bGainVisible;
+            if (!query_draw)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    meter_t *m      = &vMeters[i];
+                    query_draw      = (m->bInVisible) || (m->bOutVisible);
+                    if (query_draw)
+                        break;
+                }
+            }
+
+            if (query_draw)
+                pWrapper->query_display_draw();
+
+        #ifdef LSP_INSTRUMENT
+            profile_commit();
+        #endif /* LSP_INSTRUMENT */
+        }
 
+        void surge_filter::output_meshes()
+        {
             // Sync gain mesh
             plug::mesh_t *mesh    = pMeshGain->buffer<plug::mesh_t>();
             if ((mesh != NULL) && (mesh->isEmpty()) && (bGainVisible))
             {
                 float *x    = mesh->pvData[0];
-                float *y    = mesh->pvData[1];
 
                 dsp::copy(&x[2], vTimePoints, meta::surge_filter_metadata::MESH_POINTS);
-                sGain.read(&y[2], meta::surge_filter_metadata::MESH_POINTS);
                 x[0]        = x[2] + 0.5f;
                 x[1]        = x[0];
-                y[0]        = GAIN_AMP_0_DB;
-                y[1]        = y[2];
                 x          += meta::surge_filter_metadata::MESH_POINTS + 2;
-                y          += meta::surge_filter_metadata::MESH_POINTS + 2;
                 x[0]        = x[-1] - 0.5f;
                 x[1]        = x[0];
-                y[0]        = y[-1];
-                y[1]        = GAIN_AMP_0_DB;
 
-                mesh->data(2, meta::surge_filter_metadata::MESH_POINTS + 4);
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    meter_t *d          = (bLink) ? &vMeters[0] : &vMeters[i];
+                    float *y            = mesh->pvData[i+1];
+
+                    d->sGain.read(&y[2], meta::surge_filter_metadata::MESH_POINTS);
+                    y[0]        = GAIN_AMP_0_DB;
+                    y[1]        = y[2];
+                    y          += meta::surge_filter_metadata::MESH_POINTS + 2;
+                    y[0]        = y[-1];
+                    y[1]        = GAIN_AMP_0_DB;
+                }
+
+                mesh->data(nChannels + 1, meta::surge_filter_metadata::MESH_POINTS + 4);
             }
 
             // Sync envelope
@@ -385,8 +1553,12 @@ namespace lsp
             if ((mesh != NULL) && (mesh->isEmpty()) && (bEnvVisible))
             {
                 dsp::copy(mesh->pvData[0], vTimePoints, meta::surge_filter_metadata::MESH_POINTS);
-                sEnv.read(mesh->pvData[1], meta::surge_filter_metadata::MESH_POINTS);
-                mesh->data(2, meta::surge_filter_metadata::MESH_POINTS);
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    meter_t *d          = (bLink) ? &vMeters[0] : &vMeters[i];
+                    d->sEnv.read(mesh->pvData[i+1], meta::surge_filter_metadata::MESH_POINTS);
+                }
+                mesh->data(nChannels + 1, meta::surge_filter_metadata::MESH_POINTS);
             }
 
             // Sync input mesh
@@ -402,11 +1574,11 @@ namespace lsp
 
                 for (size_t i=0; i<nChannels; ++i)
                 {
-                    channel_t *c    = &vChannels[i];
+                    meter_t *m      = &vMeters[i];
                     float *y        = mesh->pvData[i+1];
 
-                    if (c->bInVisible)
-                        c->sIn.read(&y[1], meta::surge_filter_metadata::MESH_POINTS);
+                    if (m->bInVisible)
+                        m->sIn.read(&y[1], meta::surge_filter_metadata::MESH_POINTS);
                     else
                         dsp::fill_zero(&y[1], meta::surge_filter_metadata::MESH_POINTS);
                     y[0]    = 0.0f;
@@ -425,34 +1597,80 @@ namespace lsp
 
                 for (size_t i=0; i<nChannels; ++i)
                 {
-                    channel_t *c    = &vChannels[i];
-                    if (c->bOutVisible)
-                        c->sOut.read(mesh->pvData[i+1], meta::surge_filter_metadata::MESH_POINTS);
+                    meter_t *m      = &vMeters[i];
+                    if (m->bOutVisible)
+                        m->sOut.read(mesh->pvData[i+1], meta::surge_filter_metadata::MESH_POINTS);
                     else
                         dsp::fill_zero(mesh->pvData[i+1], meta::surge_filter_metadata::MESH_POINTS);
                 }
 
                 mesh->data(nChannels + 1, meta::surge_filter_metadata::MESH_POINTS);
             }
+        }
 
-            // Query inline display for draw
-            bool query_draw = bGainVisible;
-            if (!query_draw)
+        void surge_filter::publish_snapshot()
+        {
+            // Do not waste time if the reader did not consume the previously published snapshot
+            if (atomic_load(&nSnapMiddle) & SNAPSHOT_DIRTY)
+                return;
+
+            const size_t stride = align_size(meta::surge_filter_metadata::MESH_POINTS, DEFAULT_ALIGN);
+            snapshot_t *s       = &vSnapshots[nSnapBack];
+            float *dst          = s->vData;
+
+            s->nDetectors       = (bLink) ? 1 : nChannels;
+            s->bBypass          = vChannels[0].sBypass.bypassing();
+            s->bEnvVisible      = bEnvVisible;
+            s->bGainVisible     = bGainVisible;
+
+            for (size_t i=0; i<nChannels; ++i, dst += stride * SG_TOTAL)
             {
-                for (size_t i=0; i<nChannels; ++i)
+                meter_t *m          = &vMeters[i];
+
+                s->vInVisible[i]    = m->bInVisible;
+                s->vOutVisible[i]   = m->bOutVisible;
+                if (m->bInVisible)
+                    m->sIn.read(&dst[stride * SG_IN], meta::surge_filter_metadata::MESH_POINTS);
+                if (m->bOutVisible)
+                    m->sOut.read(&dst[stride * SG_OUT], meta::surge_filter_metadata::MESH_POINTS);
+                if (i < s->nDetectors)
                 {
-                    channel_t *c    = &vChannels[i];
-                    query_draw      = (c->bInVisible) || (c->bOutVisible);
-                    if (query_draw)
-                        break;
+                    if (bEnvVisible)
+                        m->sEnv.read(&dst[stride * SG_ENV], meta::surge_filter_metadata::MESH_POINTS);
+                    if (bGainVisible)
+                        m->sGain.read(&dst[stride * SG_GAIN], meta::surge_filter_metadata::MESH_POINTS);
                 }
             }
 
-            if (query_draw)
-                pWrapper->query_display_draw();
+            // Publish the snapshot and take the previously published one
+            uatomic_t prev      = atomic_swap(&nSnapMiddle, uatomic_t(nSnapBack | SNAPSHOT_DIRTY));
+            nSnapBack           = prev & SNAPSHOT_INDEX;
+        }
+
+        size_t surge_filter::channel_color_id(size_t index) const
+        {
+            // Mono uses the middle channel color, stereo uses left and right colors
+            return (nChannels > 1) ? 2 + (index & 1) : 0;
         }
 
         bool surge_filter::inline_display(plug::ICanvas *cv, size_t width, size_t height)
+        {
+            // Notify the processing thread that the inline display is in use
+            atomic_add(&nIDisplayReq, uatomic_t(1));
+
+        #ifdef LSP_INSTRUMENT
+            wsize_t prof_time   = profile_clock();
+            bool res            = draw_inline_display(cv, width, height);
+            wsize_t prof_delta[PS_TOTAL];
+            prof_delta[PS_IDISPLAY]     = profile_clock() - prof_time;
+            profile_update(&sIDProfile, prof_delta, PS_IDISPLAY, 1);
+            return res;
+        #else
+            return draw_inline_display(cv, width, height);
+        #endif /* LSP_INSTRUMENT */
+        }
+
+        bool surge_filter::draw_inline_display(plug::ICanvas *cv, size_t width, size_t height)
         {
             // Check proportions
             if (height > (M_RGOLD_RATIO * width))
@@ -464,9 +1682,18 @@ namespace lsp
             width   = cv->width();
             height  = cv->height();
 
+            // Take the most recent snapshot published by the processing thread
+            if (atomic_load(&nSnapMiddle) & SNAPSHOT_DIRTY)
+            {
+                uatomic_t prev      = atomic_swap(&nSnapMiddle, uatomic_t(nSnapFront));
+                nSnapFront          = prev & SNAPSHOT_INDEX;
+            }
+            const snapshot_t *s = &vSnapshots[nSnapFront];
+            const size_t stride = align_size(meta::surge_filter_metadata::MESH_POINTS, DEFAULT_ALIGN);
+
             // Clear background
-            bool bypassing = vChannels[0].sBypass.bypassing();
-            cv->set_color_rgb((bypassing) ? CV_DISABLED : CV_BACKGROUND);
+            bool bypass         = s->bBypass;
+            cv->set_color_rgb((bypass) ? CV_DISABLED : CV_BACKGROUND);
             cv->paint();
 
             // Calc axis params
@@ -508,7 +1735,6 @@ namespace lsp
                     CV_MIDDLE_CHANNEL, CV_MIDDLE_CHANNEL,
                     CV_LEFT_CHANNEL, CV_RIGHT_CHANNEL
                    };
-            bool bypass         = vChannels[0].sBypass.bypassing();
             float r             = meta::surge_filter_metadata::MESH_POINTS/float(width);
 
             for (size_t j=0; j<width; ++j)
@@ -520,80 +1746,50 @@ namespace lsp
             dsp::fill(b->v[2], width, width);
             dsp::fmadd_k3(b->v[2], b->v[0], dx, width);
 
-            // Draw input channels
-            cv->set_line_width(2.0f);
-            for (size_t i=0; i<nChannels; ++i)
-            {
-                channel_t *c    = &vChannels[i];
-                if (!c->bInVisible)
-                    continue;
-
-                // Initialize values
-                c->sIn.read(vIDisplay, meta::surge_filter_metadata::MESH_POINTS);
-                for (size_t j=0; j<width; ++j)
-                    b->v[1][j]      = vIDisplay[size_t(r*j)];
-
-                // Initialize coords
-                dsp::fill(b->v[3], height, width);
-                dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
-
-                // Draw channel
-                cv->set_color_rgb((bypass) ? CV_SILVER : cin_colors[(nChannels-1)*2 + i]);
-                cv->draw_lines(b->v[2], b->v[3], width);
-            }
-
-            // Draw output channels
+            // Draw graphs of all channels: input, output, envelope and gain
             cv->set_line_width(2.0f);
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t k=0; k<SG_TOTAL; ++k)
             {
-                channel_t *c    = &vChannels[i];
-                if (!c->bOutVisible)
-                    continue;
-
-                // Initialize values
-                c->sOut.read(vIDisplay, meta::surge_filter_metadata::MESH_POINTS);
-                for (size_t j=0; j<width; ++j)
-                    b->v[1][j]      = vIDisplay[size_t(r*j)];
-
-                // Initialize coords
-                dsp::fill(b->v[3], height, width);
-                dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
-
-                // Draw channel
-                cv->set_color_rgb((bypass) ? CV_SILVER : c_colors[(nChannels-1)*2 + i]);
-                cv->draw_lines(b->v[2], b->v[3], width);
-            }
-
-            // Draw envelope (if present)
-            if (bEnvVisible)
-            {
-                sEnv.read(vIDisplay, meta::surge_filter_metadata::MESH_POINTS);
-                for (size_t j=0; j<width; ++j)
-                    b->v[1][j]      = vIDisplay[size_t(r*j)];
-
-                // Initialize coords
-                dsp::fill(b->v[3], height, width);
-                dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
-
-                // Draw channel
-                cv->set_color_rgb((bypass) ? CV_SILVER : CV_BRIGHT_MAGENTA);
-                cv->draw_lines(b->v[2], b->v[3], width);
-            }
-
-            // Draw function (if present)
-            if (bGainVisible)
-            {
-                sGain.read(vIDisplay, meta::surge_filter_metadata::MESH_POINTS);
-                for (size_t j=0; j<width; ++j)
-                    b->v[1][j]      = vIDisplay[size_t(r*j)];
-
-                // Initialize coords
-                dsp::fill(b->v[3], height, width);
-                dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
-
-                // Draw channel
-                cv->set_color_rgb((bypass) ? CV_SILVER : CV_BRIGHT_BLUE);
-                cv->draw_lines(b->v[2], b->v[3], width);
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    uint32_t color;
+                    switch (k)
+                    {
+                        case SG_IN:
+                            if (!s->vInVisible[i])
+                                continue;
+                            color   = cin_colors[channel_color_id(i)];
+                            break;
+                        case SG_OUT:
+                            if (!s->vOutVisible[i])
+                                continue;
+                            color   = c_colors[channel_color_id(i)];
+                            break;
+                        case SG_ENV:
+                            if ((!s->bEnvVisible) || (i >= s->nDetectors))
+                                continue;
+                            color   = CV_BRIGHT_MAGENTA;
+                            break;
+                        default:
+                            if ((!s->bGainVisible) || (i >= s->nDetectors))
+                                continue;
+                            color   = CV_BRIGHT_BLUE;
+                            break;
+                    }
+
+                    // Initialize values
+                    const float *v  = &s->vData[stride * (i * SG_TOTAL + k)];
+                    for (size_t j=0; j<width; ++j)
+                        b->v[1][j]      = v[size_t(r*j)];
+
+                    // Initialize coords
+                    dsp::fill(b->v[3], height, width);
+                    dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
+
+                    // Draw channel
+                    cv->set_color_rgb((bypass) ? CV_SILVER : color);
+                    cv->draw_lines(b->v[2], b->v[3], width);
+                }
             }
 
             return true;
@@ -612,39 +1808,150 @@ namespace lsp
                 {
                     v->write("vIn", c->vIn);
                     v->write("vOut", c->vOut);
+                    v->write("vSc", c->vSc);
+                    v->write("vGc", c->vGc);
                     v->write("vBuffer", c->vBuffer);
-                    v->write_object("sBypass", &c->sBypass);
-                    v->write_object("sIn", &c->sIn);
-                    v->write_object("sOut", &c->sOut);
-                    v->write("bInVisible", c->bInVisible);
-                    v->write("bOutVisible", c->bOutVisible);
+                    v->write("vGain", c->vGain);
+                    v->write("vEnv", c->vEnv);
+                    v->write("vTemp", c->vTemp);
+                    v->write("fGainMin", c->fGainMin);
+                    v->write("fGainMax", c->fGainMax);
+                    v->write("fLastGain", c->fLastGain);
+                    v->write("fLastEnv", c->fLastEnv);
+                    v->write("fCtlSum", c->fCtlSum);
+                    v->write("fCtlPrev", c->fCtlPrev);
+                    v->write("fCtlLast", c->fCtlLast);
+                    v->write("fCtlEnvPrev", c->fCtlEnvPrev);
+                    v->write("fCtlEnv", c->fCtlEnv);
+                    v->write("nCtlPos", c->nCtlPos);
 
                     v->write("pIn", c->pIn);
                     v->write("pOut", c->pOut);
-                    v->write("pInVisible", c->pInVisible);
-                    v->write("pOutVisible", c->pOutVisible);
-                    v->write("pMeterIn", c->pMeterIn);
-                    v->write("pMeterOut", c->pMeterOut);
+                    v->write("pSc", c->pSc);
+                    v->write("pGc", c->pGc);
+
+                    v->write_object("sBypass", &c->sBypass);
+                    v->write_object("sDelay", &c->sDelay);
+                    v->write_object("sGainDelay", &c->sGainDelay);
+                    v->write_object("sEnvDelay", &c->sEnvDelay);
+                    v->write_object("sDepopper", &c->sDepopper);
+                    v->write_object("sCtlDepopper", &c->sCtlDepopper);
                 }
                 v->end_object();
             }
             v->end_array();
-
-            v->write("vBuffer", vBuffer);
-            v->write("vEnv", vEnv);
-            v->write("vTimePoints", vTimePoints);
-            v->write("vIDisplay", vIDisplay);
             v->write("fGainIn", fGainIn);
             v->write("fGainOut", fGainOut);
+            v->write("bSidechain", bSidechain);
+            v->write("bLink", bLink);
+            v->write("nLinkSwitch", nLinkSwitch);
+            v->write("bControlRate", bControlRate);
+            v->write("bCtlDelayed", bCtlDelayed);
+            v->write("nGainDelay", nGainDelay);
+            v->write("nCtlSwitch", nCtlSwitch);
+            v->write("nCtlXFade", nCtlXFade);
+            v->write("bMetering", bMetering);
+            v->write("bSleep", bSleep);
+            v->write("nSilence", nSilence);
+            v->write("nSleepThresh", nSleepThresh);
+            v->write("nSleepTime", nSleepTime);
+            v->write("nPosition", nPosition);
+            v->write("vTransitions", vTransitions);
+            v->write("nTrHead", nTrHead);
+            v->write("nTrTail", nTrTail);
+            v->write("nTrLost", atomic_load(&nTrLost));
+
+            v->begin_array("vMeters", vMeters, nChannels);
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const meter_t *m = &vMeters[i];
+                v->begin_object(m, sizeof(meter_t));
+                {
+                    v->write("fInLevel", m->fInLevel);
+                    v->write("fOutLevel", m->fOutLevel);
+                    v->write("fGainLevel", m->fGainLevel);
+                    v->write("fEnvLevel", m->fEnvLevel);
+                    v->write("bInVisible", m->bInVisible);
+                    v->write("bOutVisible", m->bOutVisible);
+                    v->write_object("sIn", &m->sIn);
+                    v->write_object("sOut", &m->sOut);
+                    v->write_object("sGain", &m->sGain);
+                    v->write_object("sEnv", &m->sEnv);
+
+                    v->write("pInVisible", m->pInVisible);
+                    v->write("pOutVisible", m->pOutVisible);
+                    v->write("pMeterIn", m->pMeterIn);
+                    v->write("pMeterOut", m->pMeterOut);
+                    v->write("pGainMeter", m->pGainMeter);
+                    v->write("pEnvMeter", m->pEnvMeter);
+                }
+                v->end_object();
+            }
+            v->end_array();
+            v->write("vTimePoints", vTimePoints);
+            v->write("fThreshOn", fThreshOn);
+            v->write("fThreshOff", fThreshOff);
+            v->write("fFadeIn", fFadeIn);
+            v->write("fFadeOut", fFadeOut);
+            v->write("fFadeInDelay", fFadeInDelay);
+            v->write("fFadeOutDelay", fFadeOutDelay);
+            v->write("fRmsLen", fRmsLen);
+            v->write("nModeIn", size_t(nModeIn));
+            v->write("nModeOut", size_t(nModeOut));
+            v->write("nLatency", nLatency);
+            v->write("nDelayCap", nDelayCap);
+        #ifdef LSP_INSTRUMENT
+            {
+                // Counters are updated by other threads, read consistent snapshots
+                profile_t prof, idprof;
+                profile_read(&prof, &sProfile);
+                profile_read(&idprof, &sIDProfile);
+                prof.vTotal[PS_IDISPLAY]    = idprof.vTotal[PS_IDISPLAY];
+                prof.vPeak[PS_IDISPLAY]     = idprof.vPeak[PS_IDISPLAY];
+
+                v->begin_object("vProfile", &sProfile, sizeof(sProfile));
+                for (size_t i=0; i<PS_TOTAL; ++i)
+                    v->write(profile_stage_names[i], prof.vTotal[i]);
+                v->end_object();
+                v->begin_object("vProfilePeak", &sProfile, sizeof(sProfile));
+                for (size_t i=0; i<PS_TOTAL; ++i)
+                    v->write(profile_stage_names[i], prof.vPeak[i]);
+                v->end_object();
+                v->write("nProfileCalls", prof.nCalls);
+                v->write("nIDisplayCalls", idprof.nCalls);
+            }
+        #endif /* LSP_INSTRUMENT */
             v->write("bGainVisible", bGainVisible);
             v->write("bEnvVisible", bEnvVisible);
+            v->write("bMeterSync", bMeterSync);
+            v->write("bUISync", bUISync);
+            v->write("nIDisplayReq", nIDisplayReq);
+            v->write("nIDisplayAck", nIDisplayAck);
+            v->write("nIDisplayTimeout", nIDisplayTimeout);
+            v->begin_array("vSnapshots", vSnapshots, 3);
+            for (size_t i=0; i<3; ++i)
+            {
+                const snapshot_t *s = &vSnapshots[i];
+                v->begin_object(s, sizeof(snapshot_t));
+                {
+                    v->write("vData", s->vData);
+                    v->write("nDetectors", s->nDetectors);
+                    v->writev("vInVisible", s->vInVisible, meta::surge_filter_metadata::CHANNELS_MAX);
+                    v->writev("vOutVisible", s->vOutVisible, meta::surge_filter_metadata::CHANNELS_MAX);
+                    v->write("bBypass", s->bBypass);
+                    v->write("bEnvVisible", s->bEnvVisible);
+                    v->write("bGainVisible", s->bGainVisible);
+                }
+                v->end_object();
+            }
+            v->end_array();
+            v->write("nSnapMiddle", nSnapMiddle);
+            v->write("nSnapBack", nSnapBack);
+            v->write("nSnapFront", nSnapFront);
             v->write("pData", pData);
             v->write("pIDisplay", pIDisplay);
 
-            v->write_object("sGain", &sGain);
-            v->write_object("sEnv", &sEnv);
             v->write_object("sActive", &sActive);
-            v->write_object("sDepopper", &sDepopper);
 
             v->write("pModeIn", pModeIn);
             v->write("pModeOut", pModeOut);
@@ -667,6 +1974,9 @@ namespace lsp
             v->write("pEnvVisible", pEnvVisible);
             v->write("pGainMeter", pGainMeter);
             v->write("pEnvMeter", pEnvMeter);
+            v->write("pLink", pLink);
+            v->write("pControlRate", pControlRate);
+            v->write("pTransitions", pTransitions);
         }
     } /* namespace plugins */
 } /* namespace lsp */
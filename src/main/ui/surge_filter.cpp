@@ -31,10 +31,12 @@ namespace lsp
         static const meta::plugin_t *plugin_uis[] =
         {
             &meta::surge_filter_mono,
-            &meta::surge_filter_stereo
+            &meta::surge_filter_stereo,
+            &meta::sc_surge_filter_mono,
+            &meta::sc_surge_filter_stereo
         };
 
-        static ui::Factory factory(plugin_uis, 2);
+        static ui::Factory factory(plugin_uis, sizeof(plugin_uis) / sizeof(plugin_uis[0]));
 
     } // namespace plugui
 } // namespace lsp
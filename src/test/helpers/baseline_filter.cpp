@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/baseline_filter.h>
+
+#define BUFFER_SIZE     0x1000
+
+namespace lsp
+{
+    namespace test
+    {
+        BaselineFilter::BaselineFilter(size_t channels)
+        {
+            nChannels       = lsp_min(channels, size_t(2));
+            fGainIn         = GAIN_AMP_0_DB;
+            fGainOut        = GAIN_AMP_0_DB;
+            vBuffer         = NULL;
+            vEnv            = NULL;
+            pData           = NULL;
+
+            sDepopper.construct();
+            for (size_t i=0; i<2; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->sBypass.construct();
+                c->sDelay.construct();
+                c->sDryDelay.construct();
+                c->vBuffer      = NULL;
+            }
+        }
+
+        BaselineFilter::~BaselineFilter()
+        {
+            destroy();
+        }
+
+        status_t BaselineFilter::init(long sample_rate)
+        {
+            destroy();
+
+            float *bufs     = alloc_aligned<float>(pData, (nChannels + 2) * BUFFER_SIZE);
+            if (bufs == NULL)
+                return STATUS_NO_MEM;
+            vBuffer         = advance_ptr_bytes<float>(bufs, BUFFER_SIZE * sizeof(float));
+            vEnv            = advance_ptr_bytes<float>(bufs, BUFFER_SIZE * sizeof(float));
+
+            const size_t max_delay  = dspu::millis_to_samples(sample_rate, meta::surge_filter_metadata::FADEOUT_MAX);
+            if (sDepopper.init(sample_rate, meta::surge_filter_metadata::FADEOUT_MAX, meta::surge_filter_metadata::RMS_MAX) != STATUS_OK)
+                return STATUS_NO_MEM;
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->vBuffer      = advance_ptr_bytes<float>(bufs, BUFFER_SIZE * sizeof(float));
+                c->sBypass.init(sample_rate);
+                c->sBypass.set_bypass(false);
+                if ((!c->sDelay.init(max_delay)) || (!c->sDryDelay.init(max_delay)))
+                    return STATUS_NO_MEM;
+            }
+
+            return STATUS_OK;
+        }
+
+        void BaselineFilter::destroy()
+        {
+            sDepopper.destroy();
+            for (size_t i=0; i<2; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->sDelay.destroy();
+                c->sDryDelay.destroy();
+                c->vBuffer      = NULL;
+            }
+
+            vBuffer         = NULL;
+            vEnv            = NULL;
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData           = NULL;
+            }
+        }
+
+        void BaselineFilter::apply(const config_t *cfg, float gain_in, float gain_out)
+        {
+            fGainIn         = gain_in;
+            fGainOut        = gain_out;
+
+            sDepopper.set_fade_in_mode(dspu::depopper_mode_t(cfg->nModeIn));
+            sDepopper.set_fade_in_threshold(cfg->fThreshOn);
+            sDepopper.set_fade_in_time(cfg->fFadeIn);
+            sDepopper.set_fade_in_delay(cfg->fFadeInDelay);
+            sDepopper.set_fade_out_mode(dspu::depopper_mode_t(cfg->nModeOut));
+            sDepopper.set_fade_out_threshold(cfg->fThreshOff);
+            sDepopper.set_fade_out_time(cfg->fFadeOut);
+            sDepopper.set_fade_out_delay(cfg->fFadeOutDelay);
+            sDepopper.set_rms_length(cfg->fRmsLen);
+            sDepopper.reconfigure();
+
+            const size_t latency    = sDepopper.latency();
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->sDelay.set_delay(latency);
+                c->sDryDelay.set_delay(latency);
+            }
+        }
+
+        void BaselineFilter::process(float * const *out, const float * const *in, size_t samples)
+        {
+            for (size_t offset=0; offset < samples; )
+            {
+                size_t to_process = lsp_min(samples - offset, size_t(BUFFER_SIZE));
+
+                // Apply input gain and compute control signal
+                for (size_t i=0; i<nChannels; ++i)
+                    dsp::mul_k3(vChannels[i].vBuffer, &in[i][offset], fGainIn, to_process);
+                if (nChannels > 1)
+                    dsp::pamax3(vBuffer, vChannels[0].vBuffer, vChannels[1].vBuffer, to_process);
+                else
+                    dsp::abs2(vBuffer, vChannels[0].vBuffer, to_process);
+
+                // Process the gain reduction control
+                sDepopper.process(vEnv, vBuffer, vBuffer, to_process);
+
+                // Apply reduction to the signal
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c    = &vChannels[i];
+                    float *dst      = &out[i][offset];
+
+                    c->sDelay.process(c->vBuffer, c->vBuffer, to_process);
+                    c->sDryDelay.process(dst, &in[i][offset], to_process);
+                    dsp::fmmul_k3(c->vBuffer, vBuffer, fGainOut, to_process);
+                    c->sBypass.process(dst, dst, c->vBuffer, to_process);
+                }
+
+                offset         += to_process;
+            }
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/plug-fw/const.h>
+#include <private/test/benchmark.h>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(ARCH_X86)
+    #include <x86intrin.h>
+#endif
+
+namespace lsp
+{
+    namespace test
+    {
+        static inline double clock_ns()
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return double(ts.tv_sec) * 1e+9 + double(ts.tv_nsec);
+        }
+
+        static inline double clock_cycles()
+        {
+        #if defined(ARCH_X86)
+            return double(__rdtsc());
+        #else
+            return 0.0;
+        #endif
+        }
+
+        static int compare_times(const void *a, const void *b)
+        {
+            double ta = *static_cast<const double *>(a);
+            double tb = *static_cast<const double *>(b);
+            return (ta < tb) ? -1 : (ta > tb) ? 1 : 0;
+        }
+
+        Benchmark::Benchmark()
+        {
+            for (size_t i=0; i<2; ++i)
+            {
+                vIn[i]          = NULL;
+                vOut[i]         = NULL;
+            }
+            nSampleRate     = 0;
+            nPeriod         = 0;
+            nMaxBlock       = 0;
+            nOffset         = 0;
+            vTimes          = NULL;
+            nMaxBlocks      = 0;
+            pHook           = NULL;
+            pHookArg        = NULL;
+            nHookIndex      = 0;
+            pReport         = NULL;
+        }
+
+        Benchmark::~Benchmark()
+        {
+            destroy();
+        }
+
+        status_t Benchmark::init(long sample_rate, size_t period, size_t max_block, size_t max_blocks)
+        {
+            destroy();
+
+            for (size_t i=0; i<2; ++i)
+            {
+                vIn[i]          = new float[period + max_block];
+                vOut[i]         = new float[max_block];
+                if ((vIn[i] == NULL) || (vOut[i] == NULL))
+                    return STATUS_NO_MEM;
+                memset(vIn[i], 0, (period + max_block) * sizeof(float));
+            }
+            vTimes          = new double[max_blocks];
+            if (vTimes == NULL)
+                return STATUS_NO_MEM;
+
+            nSampleRate     = sample_rate;
+            nPeriod         = period;
+            nMaxBlock       = max_block;
+            nOffset         = 0;
+            nMaxBlocks      = max_blocks;
+
+            return STATUS_OK;
+        }
+
+        void Benchmark::destroy()
+        {
+            for (size_t i=0; i<2; ++i)
+            {
+                if (vIn[i] != NULL)
+                {
+                    delete [] vIn[i];
+                    vIn[i]          = NULL;
+                }
+                if (vOut[i] != NULL)
+                {
+                    delete [] vOut[i];
+                    vOut[i]         = NULL;
+                }
+            }
+            if (vTimes != NULL)
+            {
+                delete [] vTimes;
+                vTimes          = NULL;
+            }
+            if (pReport != NULL)
+            {
+                fclose(pReport);
+                pReport         = NULL;
+            }
+        }
+
+        void Benchmark::commit()
+        {
+            // Blocks which cross the end of the period read the beginning of the next period
+            for (size_t i=0; i<2; ++i)
+                for (size_t j=0; j<nMaxBlock; ++j)
+                    vIn[i][nPeriod + j] = vIn[i][j % nPeriod];
+            nOffset         = 0;
+        }
+
+        void Benchmark::generate(bench_load_t load)
+        {
+            for (size_t i=0; i<2; ++i)
+            {
+                float *dst      = vIn[i];
+                switch (load)
+                {
+                    case BL_CLOSED:
+                        generate_signal(dst, nPeriod, SIG_NOISE, GAIN_AMP_M_120_DB, nSampleRate, i + 1);
+                        break;
+                    case BL_FADE:
+                    {
+                        // 100 ms bursts of noise followed by 100 ms of silence
+                        const size_t half = nSampleRate / 10;
+                        generate_signal(dst, nPeriod, SIG_NOISE, 0.25f, nSampleRate, i + 1);
+                        for (size_t j=0; j<nPeriod; ++j)
+                            if (((j / half) & 1) != 0)
+                                dst[j]          = 0.0f;
+                        break;
+                    }
+                    case BL_GAPS:
+                        generate_signal(dst, nPeriod, SIG_GAPS, 0.25f, nSampleRate, i + 1);
+                        break;
+                    default:
+                        generate_signal(dst, nPeriod, SIG_NOISE, 0.25f, nSampleRate, i + 1);
+                        break;
+                }
+            }
+            commit();
+        }
+
+        void Benchmark::set_hook(bench_hook_t hook, void *arg)
+        {
+            pHook           = hook;
+            pHookArg        = arg;
+            nHookIndex      = 0;
+        }
+
+        void Benchmark::process(SurgeFilterHost *host, size_t block)
+        {
+            const float *in[2]  = { &vIn[0][nOffset], &vIn[1][nOffset] };
+            const float * const *sc = (host->sidechain()) ? in : NULL;
+
+            host->process(vOut, in, sc, NULL, block, block);
+            nOffset         = (nOffset + block) % nPeriod;
+        }
+
+        void Benchmark::run(SurgeFilterHost *host, size_t block)
+        {
+            if (pHook != NULL)
+                pHook(host, nHookIndex++, pHookArg);
+            process(host, block);
+        }
+
+        void Benchmark::warm_up(SurgeFilterHost *host)
+        {
+            for (size_t i=0; i<nPeriod; i += nMaxBlock)
+                run(host, nMaxBlock);
+        }
+
+        void Benchmark::measure(bench_t *res, SurgeFilterHost *host, size_t block, size_t blocks)
+        {
+            blocks          = lsp_min(blocks, nMaxBlocks);
+
+            double total_ns = 0.0, total_cycles = 0.0;
+            for (size_t i=0; i<blocks; ++i)
+            {
+                if (pHook != NULL)
+                    pHook(host, nHookIndex++, pHookArg);
+
+                double ns       = clock_ns();
+                double cycles   = clock_cycles();
+                process(host, block);
+                cycles          = clock_cycles() - cycles;
+                ns              = clock_ns() - ns;
+
+                vTimes[i]       = ns;
+                total_ns       += ns;
+                total_cycles   += cycles;
+            }
+
+            qsort(vTimes, blocks, sizeof(double), compare_times);
+
+            const double samples    = double(block) * blocks;
+            res->nBlock             = block;
+            res->nBlocks            = blocks;
+            res->fNsPerSample       = total_ns / samples;
+            res->fCyclesPerSample   = total_cycles / samples;
+            res->fP99Ns             = (blocks > 0) ? vTimes[((blocks * 99 + 99) / 100) - 1] : 0.0;
+        }
+
+        status_t Benchmark::open_report(const char *dir, const char *name)
+        {
+            if (pReport != NULL)
+                fclose(pReport);
+
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s/%s.csv", dir, name);
+            printf("Writing report to file %s\n", path);
+
+            pReport         = fopen(path, "w");
+            if (pReport == NULL)
+                return STATUS_IO_ERROR;
+
+            fprintf(pReport, "name;block;blocks;ns_per_sample;cycles_per_sample;p99_block_ns\n");
+            return STATUS_OK;
+        }
+
+        void Benchmark::report(const char *name, const bench_t *res)
+        {
+            if (pReport == NULL)
+                return;
+
+            fprintf(pReport, "%s;%d;%d;%.4f;%.4f;%.1f\n",
+                name, int(res->nBlock), int(res->nBlocks),
+                res->fNsPerSample, res->fCyclesPerSample, res->fP99Ns);
+            fflush(pReport);
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
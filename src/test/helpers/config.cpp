@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/plug-fw/const.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/config.h>
+
+#include <stdio.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        static constexpr size_t MODES           = 5;
+
+        static const float thresholds[][2] =
+        {
+            { GAIN_AMP_M_72_DB, GAIN_AMP_M_72_DB },
+            { GAIN_AMP_M_36_DB, GAIN_AMP_M_48_DB }
+        };
+
+        static const float rms_lengths[]        = { 4.0f, 30.0f };
+
+        static const float fades[][2] =
+        {
+            { 10.0f, 0.0f },
+            { 100.0f, 50.0f }
+        };
+
+        static const float delays[][2] =
+        {
+            { 0.0f, 0.0f },
+            { 10.0f, 20.0f }
+        };
+
+        void config_default(config_t *cfg)
+        {
+            cfg->nModeIn        = 3;
+            cfg->nModeOut       = 3;
+            cfg->fThreshOn      = meta::surge_filter_metadata::THRESH_DFL;
+            cfg->fThreshOff     = meta::surge_filter_metadata::THRESH_DFL;
+            cfg->fRmsLen        = meta::surge_filter_metadata::RMS_DFL;
+            cfg->fFadeIn        = meta::surge_filter_metadata::FADEIN_DFL;
+            cfg->fFadeOut       = meta::surge_filter_metadata::FADEOUT_DFL;
+            cfg->fFadeInDelay   = meta::surge_filter_metadata::PAUSE_DFL;
+            cfg->fFadeOutDelay  = meta::surge_filter_metadata::PAUSE_DFL;
+            cfg->bControlRate   = false;
+        }
+
+        size_t config_grid_size()
+        {
+            return MODES * MODES * 2 * 2 * 2 * 2 * 2;
+        }
+
+        void config_grid(config_t *cfg, size_t index)
+        {
+            cfg->bControlRate   = index & 1;
+            index             >>= 1;
+            const float *d      = delays[index & 1];
+            index             >>= 1;
+            const float *f      = fades[index & 1];
+            index             >>= 1;
+            cfg->fRmsLen        = rms_lengths[index & 1];
+            index             >>= 1;
+            const float *t      = thresholds[index & 1];
+            index             >>= 1;
+            cfg->nModeOut       = index % MODES;
+            cfg->nModeIn        = (index / MODES) % MODES;
+
+            cfg->fThreshOn      = t[0];
+            cfg->fThreshOff     = t[1];
+            cfg->fFadeIn        = f[0];
+            cfg->fFadeOut       = f[1];
+            cfg->fFadeInDelay   = d[0];
+            cfg->fFadeOutDelay  = d[1];
+        }
+
+        void config_format(char *dst, size_t len, const config_t *cfg)
+        {
+            snprintf(dst, len, "mode=%d/%d thr=%.1f/%.1f rms=%.1f fade=%.1f/%.1f delay=%.1f/%.1f crate=%d",
+                int(cfg->nModeIn), int(cfg->nModeOut),
+                dspu::gain_to_db(cfg->fThreshOn), dspu::gain_to_db(cfg->fThreshOff),
+                cfg->fRmsLen, cfg->fFadeIn, cfg->fFadeOut, cfg->fFadeInDelay, cfg->fFadeOutDelay,
+                int(cfg->bControlRate));
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
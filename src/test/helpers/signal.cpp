@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/test/signal.h>
+
+#include <math.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        static const char *signal_names[] =
+        {
+            "step",
+            "bursts",
+            "dc",
+            "noise",
+            "gaps",
+            "edge"
+        };
+
+        // Park-Miller generator: the sequence does not depend on the C runtime
+        static inline float noise(uint32_t *state)
+        {
+            *state          = uint32_t((uint64_t(*state) * 48271u) % 0x7fffffffu);
+            return float(*state) / float(0x7fffffff) * 2.0f - 1.0f;
+        }
+
+        const char *signal_name(signal_t type)
+        {
+            return (type < SIG_TOTAL) ? signal_names[type] : "unknown";
+        }
+
+        void generate_signal(float *dst, size_t count, signal_t type, float level, long sample_rate, uint32_t seed)
+        {
+            const size_t ms     = sample_rate / 1000;
+            const size_t shift  = (seed % 7) * ms;
+            uint32_t state      = seed * 16807u + 1u;
+
+            switch (type)
+            {
+                case SIG_STEP:
+                {
+                    size_t on       = count / 4 + shift;
+                    size_t off      = (count * 3) / 4;
+                    for (size_t i=0; i<count; ++i)
+                        dst[i]          = ((i >= on) && (i < off)) ? level : 0.0f;
+                    break;
+                }
+
+                case SIG_BURSTS:
+                {
+                    // 50 ms bursts of 1 kHz sine every 150 ms
+                    const float w   = 2.0f * M_PI * 1000.0f / sample_rate;
+                    const size_t period = 150 * ms;
+                    for (size_t i=0; i<count; ++i)
+                    {
+                        size_t t        = (i + period - shift) % period;
+                        dst[i]          = (t < 50 * ms) ? level * sinf(w * t) : 0.0f;
+                    }
+                    break;
+                }
+
+                case SIG_DC:
+                    for (size_t i=0; i<count; ++i)
+                        dst[i]          = level;
+                    break;
+
+                case SIG_NOISE:
+                {
+                    size_t on       = 10 * ms + shift;
+                    for (size_t i=0; i<count; ++i)
+                        dst[i]          = (i >= on) ? level * noise(&state) : 0.0f;
+                    break;
+                }
+
+                case SIG_GAPS:
+                {
+                    // 100 ms of noise followed by gaps of 10, 50 and 200 ms
+                    static const size_t gaps[] = { 10, 50, 200 };
+                    size_t pos      = shift;
+                    for (size_t i=0; i<pos && i<count; ++i)
+                        dst[i]          = 0.0f;
+                    for (size_t k=0; pos < count; ++k)
+                    {
+                        size_t on       = lsp_min(pos + 100 * ms, count);
+                        for ( ; pos < on; ++pos)
+                            dst[pos]        = level * noise(&state);
+                        size_t off      = lsp_min(pos + gaps[k % 3] * ms, count);
+                        for ( ; pos < off; ++pos)
+                            dst[pos]        = 0.0f;
+                    }
+                    break;
+                }
+
+                case SIG_EDGE:
+                {
+                    // Square wave with RMS level 5% above and 5% below the level, switching every 30 ms
+                    const size_t half   = sample_rate / 200;
+                    for (size_t i=0; i<count; ++i)
+                    {
+                        float amp       = (((i + shift) / (30 * ms)) & 1) ? level * 0.95f : level * 1.05f;
+                        dst[i]          = ((i / half) & 1) ? -amp : amp;
+                    }
+                    break;
+                }
+
+                default:
+                    for (size_t i=0; i<count; ++i)
+                        dst[i]          = 0.0f;
+                    break;
+            }
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/dsp/dsp.h>
+#include <private/test/surge_filter_host.h>
+
+#include <string.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        //-------------------------------------------------------------------------
+        class SurgeFilterHost::Port: public plug::IPort
+        {
+            protected:
+                float               fValue;
+                void               *pBuffer;
+
+            public:
+                explicit Port(const meta::port_t *meta): plug::IPort(meta)
+                {
+                    fValue      = meta->start;
+                    pBuffer     = NULL;
+                }
+
+            public:
+                virtual float value() override              { return fValue;    }
+                virtual void set_value(float value) override { fValue = value;  }
+                virtual void *buffer() override             { return pBuffer;   }
+
+            public:
+                inline void bind(void *buffer)              { pBuffer = buffer; }
+        };
+
+        class SurgeFilterHost::Wrapper: public plug::IWrapper
+        {
+            public:
+                explicit Wrapper(plug::Module *plugin): plug::IWrapper(plugin, NULL)
+                {
+                }
+
+            public:
+                virtual void query_display_draw() override
+                {
+                    // Nothing to draw
+                }
+        };
+
+        //-------------------------------------------------------------------------
+        static bool is_port(const meta::port_t *meta, const char *prefix)
+        {
+            size_t len      = strlen(prefix);
+            if (strncmp(meta->id, prefix, len) != 0)
+                return false;
+            return (meta->id[len] == '\0') || (meta->id[len] == '_');
+        }
+
+        static plug::Module *create_module(const meta::plugin_t *metadata)
+        {
+            for (plug::Factory *f = plug::Factory::root(); f != NULL; f = f->next())
+            {
+                for (size_t i=0; ; ++i)
+                {
+                    const meta::plugin_t *meta = f->enumerate(i);
+                    if (meta == NULL)
+                        break;
+                    if (meta == metadata)
+                        return f->create(meta);
+                }
+            }
+
+            return NULL;
+        }
+
+        //-------------------------------------------------------------------------
+        SurgeFilterHost::SurgeFilterHost(const meta::plugin_t *metadata)
+        {
+            pMetadata       = metadata;
+            pModule         = NULL;
+            pWrapper        = NULL;
+            vPorts          = NULL;
+            nPorts          = 0;
+            for (size_t i=0; i<2; ++i)
+            {
+                vIn[i]          = NULL;
+                vOut[i]         = NULL;
+                vSc[i]          = NULL;
+                vGc[i]          = NULL;
+            }
+            pBypass         = NULL;
+            nChannels       = 0;
+            bUpdate         = true;
+        }
+
+        SurgeFilterHost::~SurgeFilterHost()
+        {
+            destroy();
+        }
+
+        status_t SurgeFilterHost::init(long sample_rate)
+        {
+            dsp::init();
+
+            // Create the plugin
+            pModule         = create_module(pMetadata);
+            if (pModule == NULL)
+                return STATUS_NOT_FOUND;
+            pWrapper        = new Wrapper(pModule);
+            if (pWrapper == NULL)
+                return STATUS_NO_MEM;
+
+            // Create ports
+            for (const meta::port_t *p = pMetadata->ports; p->id != NULL; ++p)
+                ++nPorts;
+            vPorts          = new plug::IPort *[nPorts];
+            if (vPorts == NULL)
+                return STATUS_NO_MEM;
+
+            size_t n_in = 0, n_out = 0, n_sc = 0, n_gc = 0;
+            for (size_t i=0; i<nPorts; ++i)
+            {
+                const meta::port_t *p = &pMetadata->ports[i];
+                Port *port      = new Port(p);
+                if (port == NULL)
+                    return STATUS_NO_MEM;
+                vPorts[i]       = port;
+
+                if (p->role == meta::R_BYPASS)
+                    pBypass         = port;
+                else if (p->role != meta::R_AUDIO)
+                    continue;
+                else if (is_port(p, "in"))
+                    vIn[n_in++]     = port;
+                else if (is_port(p, "out"))
+                    vOut[n_out++]   = port;
+                else if (is_port(p, "sc"))
+                    vSc[n_sc++]     = port;
+                else if (is_port(p, "gc"))
+                    vGc[n_gc++]     = port;
+            }
+            nChannels       = n_in;
+
+            // Initialize the plugin
+            pModule->init(pWrapper, vPorts);
+            pModule->set_sample_rate(sample_rate);
+            bUpdate         = true;
+
+            return STATUS_OK;
+        }
+
+        void SurgeFilterHost::destroy()
+        {
+            if (pModule != NULL)
+            {
+                pModule->destroy();
+                delete pModule;
+                pModule         = NULL;
+            }
+
+            if (pWrapper != NULL)
+            {
+                delete pWrapper;
+                pWrapper        = NULL;
+            }
+
+            if (vPorts != NULL)
+            {
+                for (size_t i=0; i<nPorts; ++i)
+                    if (vPorts[i] != NULL)
+                        delete vPorts[i];
+                delete [] vPorts;
+                vPorts          = NULL;
+            }
+            nPorts          = 0;
+        }
+
+        SurgeFilterHost::Port *SurgeFilterHost::find_port(const char *id) const
+        {
+            for (size_t i=0; i<nPorts; ++i)
+            {
+                if (strcmp(vPorts[i]->metadata()->id, id) == 0)
+                    return static_cast<Port *>(vPorts[i]);
+            }
+            return NULL;
+        }
+
+        bool SurgeFilterHost::set(const char *id, float value)
+        {
+            Port *port      = find_port(id);
+            if (port == NULL)
+                return false;
+
+            port->set_value(value);
+            bUpdate         = true;
+            return true;
+        }
+
+        float SurgeFilterHost::get(const char *id) const
+        {
+            Port *port      = find_port(id);
+            return (port != NULL) ? port->value() : 0.0f;
+        }
+
+        void SurgeFilterHost::apply(const config_t *cfg)
+        {
+            set("modein", cfg->nModeIn);
+            set("modeout", cfg->nModeOut);
+            set("thr_on", cfg->fThreshOn);
+            set("thr_off", cfg->fThreshOff);
+            set("rms", cfg->fRmsLen);
+            set("fadein", cfg->fFadeIn);
+            set("fadeout", cfg->fFadeOut);
+            set("fidelay", cfg->fFadeInDelay);
+            set("fodelay", cfg->fFadeOutDelay);
+            set("crate", (cfg->bControlRate) ? 1.0f : 0.0f);
+        }
+
+        void SurgeFilterHost::set_bypass(bool bypass)
+        {
+            if (pBypass == NULL)
+                return;
+            pBypass->set_value((bypass) ? 1.0f : 0.0f);
+            bUpdate         = true;
+        }
+
+        void SurgeFilterHost::set_ui_active(bool active)
+        {
+            if (active)
+                pModule->activate_ui();
+            else
+                pModule->deactivate_ui();
+        }
+
+        ssize_t SurgeFilterHost::latency() const
+        {
+            return pModule->latency();
+        }
+
+        void SurgeFilterHost::process(float * const *out, const float * const *in,
+            const float * const *sc, float * const *gc,
+            size_t samples, size_t block)
+        {
+            process(out, in, sc, gc, samples, &block, 1);
+        }
+
+        void SurgeFilterHost::process(float * const *out, const float * const *in,
+            const float * const *sc, float * const *gc,
+            size_t samples, const size_t *blocks, size_t count)
+        {
+            for (size_t offset=0, index=0; offset < samples; index = (index + 1) % count)
+            {
+                size_t to_do    = lsp_min(samples - offset, blocks[index]);
+
+                // Apply settings like the wrapper does before the process() call
+                if (bUpdate)
+                {
+                    pModule->update_settings();
+                    bUpdate         = false;
+                }
+
+                // Bind buffers to the ports
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    vIn[i]->bind(const_cast<float *>(&in[i][offset]));
+                    vOut[i]->bind(&out[i][offset]);
+                    if (vSc[i] != NULL)
+                        vSc[i]->bind(const_cast<float *>((sc != NULL) ? &sc[i][offset] : &in[i][offset]));
+                    if (vGc[i] != NULL)
+                        vGc[i]->bind((gc != NULL) ? &gc[i][offset] : NULL);
+                }
+
+                pModule->process(to_do);
+                offset         += to_do;
+            }
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/benchmark.h>
+#include <private/test/config.h>
+#include <private/test/surge_filter_host.h>
+
+#include <math.h>
+#include <stdio.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t PERIOD          = SAMPLE_RATE;
+    static constexpr size_t MAX_BLOCK       = 1024;
+    static constexpr size_t MAX_BLOCKS      = SAMPLE_RATE / 8;
+    static constexpr size_t LFO_PERIOD      = 0x100;    // Period of automation in process() calls
+
+    static const size_t block_sizes[]       = { 32, 64, 256, 1024 };
+
+    enum automation_t
+    {
+        AU_NONE,        // No automation
+        AU_OUTPUT,      // Output gain, does not affect the detection
+        AU_VISIBILITY,  // Visibility of graphs, does not affect the processing
+        AU_THRESHOLD,   // Thresholds, the depoppers need to be reconfigured
+        AU_FADE_OUT,    // Fade out time, the depoppers need to be reconfigured and the latency changes
+
+        AU_TOTAL
+    };
+
+    static const char *automation_names[] =
+    {
+        "none",
+        "output",
+        "visibility",
+        "threshold",
+        "fadeout"
+    };
+
+    static void automate(test::SurgeFilterHost *host, size_t index, void *arg)
+    {
+        const automation_t type = *static_cast<const automation_t *>(arg);
+        const float lfo         = 0.5f + 0.5f * sinf((2.0f * M_PI * (index % LFO_PERIOD)) / LFO_PERIOD);
+
+        switch (type)
+        {
+            case AU_OUTPUT:
+                host->set("output", GAIN_AMP_M_6_DB + lfo * (GAIN_AMP_0_DB - GAIN_AMP_M_6_DB));
+                break;
+            case AU_VISIBILITY:
+                host->set("ev", index & 1);
+                break;
+            case AU_THRESHOLD:
+                host->set("thr_on", GAIN_AMP_M_72_DB + lfo * (GAIN_AMP_M_48_DB - GAIN_AMP_M_72_DB));
+                host->set("thr_off", GAIN_AMP_M_72_DB + lfo * (GAIN_AMP_M_48_DB - GAIN_AMP_M_72_DB));
+                break;
+            case AU_FADE_OUT:
+                host->set("fadeout", lfo * 50.0f);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Cost of the parameter automation: parameters are changed before each process() call,
+ * so update_settings() is called each time
+ */
+PTEST_BEGIN("surge_filter", automation, 0.1f, 256)
+
+    void benchmark(test::Benchmark *bench, const meta::plugin_t *meta, const char *layout, automation_t type)
+    {
+        test::config_t cfg;
+        test::config_default(&cfg);
+
+        test::SurgeFilterHost host(meta);
+        if (host.init(SAMPLE_RATE) != STATUS_OK)
+            return;
+        host.apply(&cfg);
+
+        char name[128];
+        snprintf(name, sizeof(name), "%s/%s", layout, automation_names[type]);
+        bench->set_hook(automate, &type);
+
+        for (size_t i=0; i<sizeof(block_sizes)/sizeof(size_t); ++i)
+        {
+            test::bench_t res;
+            BENCHMARK_PROCESS(bench, &host, name, block_sizes[i], MAX_BLOCKS, &res);
+        }
+
+        bench->set_hook(NULL, NULL);
+    }
+
+    PTEST_MAIN
+    {
+        test::Benchmark bench;
+        if (bench.init(SAMPLE_RATE, PERIOD, MAX_BLOCK, MAX_BLOCKS) != STATUS_OK)
+            return;
+        bench.generate(test::BL_GAPS);
+        if (bench.open_report(tempdir(), full_name()) != STATUS_OK)
+            return;
+
+        for (size_t i=0; i<AU_TOTAL; ++i)
+            benchmark(&bench, &meta::surge_filter_mono, "mono", automation_t(i));
+        PTEST_SEPARATOR;
+        for (size_t i=0; i<AU_TOTAL; ++i)
+            benchmark(&bench, &meta::surge_filter_stereo, "stereo", automation_t(i));
+    }
+
+PTEST_END
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/benchmark.h>
+#include <private/test/config.h>
+#include <private/test/surge_filter_host.h>
+
+#include <stdio.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t PERIOD          = SAMPLE_RATE;
+    static constexpr size_t MAX_BLOCK       = 128;
+    static constexpr size_t MAX_BLOCKS      = SAMPLE_RATE / 4;
+
+    static const size_t block_sizes[]       = { 16, 32, 48, 64, 96, 128 };
+}
+
+/**
+ * Per-call overhead of the process() call at small block sizes. The time of the call is
+ * approximated by the linear function of the block size, the constant term is the overhead
+ * of the call which does not depend on the number of samples. The result of the specialized
+ * processing routines can be compared with the previous revisions of the plugin
+ */
+PTEST_BEGIN("surge_filter", block_overhead, 0.1f, 256)
+
+    void benchmark(test::Benchmark *bench, const meta::plugin_t *meta, const char *name)
+    {
+        test::config_t cfg;
+        test::config_default(&cfg);
+
+        test::SurgeFilterHost host(meta);
+        if (host.init(SAMPLE_RATE) != STATUS_OK)
+            return;
+        host.apply(&cfg);
+
+        // Linear regression of the call time over the block size
+        double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+        const size_t n = sizeof(block_sizes) / sizeof(size_t);
+
+        for (size_t i=0; i<n; ++i)
+        {
+            const size_t block  = block_sizes[i];
+            test::bench_t res;
+            BENCHMARK_PROCESS(bench, &host, name, block, MAX_BLOCKS, &res);
+
+            const double call   = res.fNsPerSample * block;
+            sx                 += block;
+            sy                 += call;
+            sxx                += double(block) * block;
+            sxy                += double(block) * call;
+        }
+
+        const double per_sample = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+        const double overhead   = (sy - per_sample * sx) / n;
+        printf("%s: overhead per call: %.1f ns, time per sample: %.3f ns\n", name, overhead, per_sample);
+    }
+
+    PTEST_MAIN
+    {
+        test::Benchmark bench;
+        if (bench.init(SAMPLE_RATE, PERIOD, MAX_BLOCK, MAX_BLOCKS) != STATUS_OK)
+            return;
+        bench.generate(test::BL_OPEN);
+        if (bench.open_report(tempdir(), full_name()) != STATUS_OK)
+            return;
+
+        benchmark(&bench, &meta::surge_filter_mono, "mono");
+        benchmark(&bench, &meta::surge_filter_stereo, "stereo");
+        benchmark(&bench, &meta::sc_surge_filter_mono, "sc_mono");
+        benchmark(&bench, &meta::sc_surge_filter_stereo, "sc_stereo");
+    }
+
+PTEST_END
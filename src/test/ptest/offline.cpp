@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/benchmark.h>
+#include <private/test/config.h>
+#include <private/test/surge_filter_host.h>
+
+#include <stdio.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t PERIOD          = (SAMPLE_RATE * 6) / 5;    // 1.2 s of input data
+    static constexpr size_t MIN_BLOCK       = 1024;
+    static constexpr size_t MAX_BLOCK       = 32768;
+    static constexpr size_t MAX_BLOCKS      = 256;
+}
+
+/**
+ * Render of long files with huge blocks: the plugin with active UI (metering is on)
+ * compared to the plugin without UI (offline render, metering is off)
+ */
+PTEST_BEGIN("surge_filter", offline, 0.1f, 16)
+
+    void benchmark(test::Benchmark *bench, const meta::plugin_t *meta, bool ui)
+    {
+        test::config_t cfg;
+        test::config_default(&cfg);
+
+        test::SurgeFilterHost host(meta);
+        if (host.init(SAMPLE_RATE) != STATUS_OK)
+            return;
+        host.apply(&cfg);
+        host.set("input", GAIN_AMP_M_6_DB);
+        host.set_ui_active(ui);
+
+        char name[128];
+        snprintf(name, sizeof(name), "%s/%s",
+            (host.channels() > 1) ? "stereo" : "mono", (ui) ? "realtime" : "offline");
+
+        for (size_t block=MIN_BLOCK; block<=MAX_BLOCK; block <<= 1)
+        {
+            test::bench_t res;
+            BENCHMARK_PROCESS(bench, &host, name, block, lsp_max(size_t(64), (SAMPLE_RATE * 4) / block), &res);
+        }
+    }
+
+    PTEST_MAIN
+    {
+        test::Benchmark bench;
+        if (bench.init(SAMPLE_RATE, PERIOD, MAX_BLOCK, MAX_BLOCKS) != STATUS_OK)
+            return;
+        bench.generate(test::BL_GAPS);
+        if (bench.open_report(tempdir(), full_name()) != STATUS_OK)
+            return;
+
+        const meta::plugin_t *plugins[] = { &meta::surge_filter_mono, &meta::surge_filter_stereo };
+        for (size_t i=0; i<sizeof(plugins)/sizeof(plugins[0]); ++i)
+        {
+            benchmark(&bench, plugins[i], true);
+            benchmark(&bench, plugins[i], false);
+            PTEST_SEPARATOR;
+        }
+    }
+
+PTEST_END
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/benchmark.h>
+#include <private/test/config.h>
+#include <private/test/surge_filter_host.h>
+
+#include <stdio.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t PERIOD          = (SAMPLE_RATE * 6) / 5;    // 1.2 s of input data
+    static constexpr size_t MAX_BLOCK       = 8192;
+    static constexpr size_t MAX_BLOCKS      = SAMPLE_RATE / 4;
+
+    enum state_t
+    {
+        ST_OPEN,        // Signal above the threshold, the filter is open
+        ST_CLOSED,      // Signal below the threshold, the filter is closed but does not sleep
+        ST_FADE,        // Bursts shorter than fade times, the filter is fading most of the time
+        ST_BYPASS,      // Signal above the threshold, the plugin is bypassed
+
+        ST_TOTAL
+    };
+
+    static const char *state_names[] =
+    {
+        "open",
+        "closed",
+        "fade",
+        "bypass"
+    };
+
+    static const test::bench_load_t state_loads[] =
+    {
+        test::BL_OPEN,
+        test::BL_CLOSED,
+        test::BL_FADE,
+        test::BL_OPEN
+    };
+
+    static const char *mode_names[] =
+    {
+        "linear",
+        "cubic",
+        "sine",
+        "gaussian",
+        "parabolic"
+    };
+}
+
+PTEST_BEGIN("surge_filter", process, 0.1f, 64)
+
+    void benchmark(test::Benchmark *bench, const meta::plugin_t *meta, size_t mode, state_t state)
+    {
+        test::config_t cfg;
+        cfg.nModeIn         = mode;
+        cfg.nModeOut        = mode;
+        cfg.fThreshOn       = meta::surge_filter_metadata::THRESH_DFL;
+        cfg.fThreshOff      = meta::surge_filter_metadata::THRESH_DFL;
+        cfg.fRmsLen         = meta::surge_filter_metadata::RMS_MIN;
+        cfg.fFadeIn         = (state == ST_FADE) ? meta::surge_filter_metadata::FADEOUT_MAX : meta::surge_filter_metadata::FADEIN_DFL;
+        cfg.fFadeOut        = (state == ST_FADE) ? meta::surge_filter_metadata::FADEOUT_MAX : meta::surge_filter_metadata::FADEOUT_DFL;
+        cfg.fFadeInDelay    = 0.0f;
+        cfg.fFadeOutDelay   = 0.0f;
+        cfg.bControlRate    = false;
+
+        test::SurgeFilterHost host(meta);
+        if (host.init(SAMPLE_RATE) != STATUS_OK)
+            return;
+        host.apply(&cfg);
+        host.set_bypass(state == ST_BYPASS);
+
+        bench->generate(state_loads[state]);
+        char name[128];
+        snprintf(name, sizeof(name), "%s/%s/%s",
+            (host.channels() > 1) ? "stereo" : "mono", mode_names[mode], state_names[state]);
+
+        for (size_t block=1; block<=MAX_BLOCK; block <<= 1)
+        {
+            test::bench_t res;
+            BENCHMARK_PROCESS(bench, &host, name, block, lsp_max(size_t(64), SAMPLE_RATE / (block * 4)), &res);
+        }
+    }
+
+    PTEST_MAIN
+    {
+        test::Benchmark bench;
+        if (bench.init(SAMPLE_RATE, PERIOD, MAX_BLOCK, MAX_BLOCKS) != STATUS_OK)
+            return;
+        if (bench.open_report(tempdir(), full_name()) != STATUS_OK)
+            return;
+
+        const meta::plugin_t *plugins[] = { &meta::surge_filter_mono, &meta::surge_filter_stereo };
+        for (size_t i=0; i<sizeof(plugins)/sizeof(plugins[0]); ++i)
+            for (size_t mode=0; mode<sizeof(mode_names)/sizeof(mode_names[0]); ++mode)
+            {
+                for (size_t state=0; state<ST_TOTAL; ++state)
+                    benchmark(&bench, plugins[i], mode, state_t(state));
+                PTEST_SEPARATOR;
+            }
+    }
+
+PTEST_END
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/baseline_filter.h>
+#include <private/test/config.h>
+#include <private/test/signal.h>
+#include <private/test/surge_filter_host.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t SAMPLES         = SAMPLE_RATE / 2;
+    static constexpr float LEVEL            = 0.25f;
+
+    static const size_t blocks[]            = { 7, 64, 1, 333, 4096, 17, 1023 };
+
+    typedef struct gain_t
+    {
+        float       fIn;
+        float       fOut;
+    } gain_t;
+
+    static const gain_t gains[] =
+    {
+        { GAIN_AMP_0_DB,    GAIN_AMP_0_DB   },
+        { GAIN_AMP_P_6_DB,  GAIN_AMP_M_6_DB }
+    };
+}
+
+UTEST_BEGIN("surge_filter", baseline)
+
+    void check_variant(const meta::plugin_t *meta, float * const *in, float * const *out, float * const *ref,
+        const test::config_t *cfg, test::signal_t type, const gain_t *gain)
+    {
+        test::SurgeFilterHost host(meta);
+        UTEST_ASSERT(host.init(SAMPLE_RATE) == STATUS_OK);
+        host.apply(cfg);
+        host.set("input", gain->fIn);
+        host.set("output", gain->fOut);
+        host.process(out, in, NULL, NULL, SAMPLES, blocks, sizeof(blocks)/sizeof(size_t));
+
+        test::BaselineFilter model(host.channels());
+        UTEST_ASSERT(model.init(SAMPLE_RATE) == STATUS_OK);
+        model.apply(cfg, gain->fIn, gain->fOut);
+        model.process(ref, in, SAMPLES);
+
+        char buf[256];
+        test::config_format(buf, sizeof(buf), cfg);
+        UTEST_ASSERT_MSG(host.latency() == ssize_t(model.latency()),
+            "%s: latency %d != %d, %s\n", meta->uid, int(host.latency()), int(model.latency()), buf);
+
+        for (size_t i=0; i<host.channels(); ++i)
+            for (size_t j=0; j<SAMPLES; ++j)
+            {
+                if (out[i][j] == ref[i][j])
+                    continue;
+                UTEST_FAIL_MSG("%s: channel %d mismatch at sample %d: %.10g != %.10g, signal=%s, gain in=%g out=%g, %s\n",
+                    meta->uid, int(i), int(j), out[i][j], ref[i][j], test::signal_name(type),
+                    gain->fIn, gain->fOut, buf);
+            }
+    }
+
+    UTEST_MAIN
+    {
+        float *in[2], *out[2], *ref[2];
+        for (size_t i=0; i<2; ++i)
+        {
+            in[i]       = new float[SAMPLES];
+            out[i]      = new float[SAMPLES];
+            ref[i]      = new float[SAMPLES];
+        }
+
+        // The sample-rate detection of versions without sidechain in linked mode should
+        // produce the same output as the processing before the block processing was introduced
+        test::config_t cfg;
+        const size_t configs = test::config_grid_size();
+        for (size_t i=0; i<configs; ++i)
+        {
+            test::config_grid(&cfg, i);
+            if (cfg.bControlRate)
+                continue;
+
+            for (size_t j=0; j<test::SIG_TOTAL; ++j)
+            {
+                const test::signal_t type = test::signal_t(j);
+                const float level   = (type == test::SIG_EDGE) ? cfg.fThreshOn : LEVEL;
+                test::generate_signal(in[0], SAMPLES, type, level, SAMPLE_RATE, 0);
+                test::generate_signal(in[1], SAMPLES, type, level * 0.5f, SAMPLE_RATE, 3);
+
+                for (size_t k=0; k<sizeof(gains)/sizeof(gain_t); ++k)
+                {
+                    check_variant(&meta::surge_filter_mono, in, out, ref, &cfg, type, &gains[k]);
+                    check_variant(&meta::surge_filter_stereo, in, out, ref, &cfg, type, &gains[k]);
+                }
+            }
+        }
+
+        for (size_t i=0; i<2; ++i)
+        {
+            delete [] in[i];
+            delete [] out[i];
+            delete [] ref[i];
+        }
+    }
+
+UTEST_END
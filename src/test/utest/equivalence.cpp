@@ -0,0 +1,502 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/config.h>
+#include <private/test/signal.h>
+#include <private/test/surge_filter_host.h>
+
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t SAMPLES         = SAMPLE_RATE / 2;
+    static constexpr float LEVEL            = 0.25f;
+
+    static const size_t regular_blocks[]    = { 1024 };
+    static const size_t irregular_blocks[]  = { 7, 64, 1, 333, 4096, 17, 1023 };
+    static const size_t single_blocks[]     = { 1 };
+
+    /**
+     * Set of buffers for stereo rendering
+     */
+    typedef struct render_t
+    {
+        float      *vIn[2];
+        float      *vOut[2];
+        float      *vGc[2];
+        ssize_t     nLatency;
+    } render_t;
+
+    static void init_render(render_t *r, size_t samples)
+    {
+        for (size_t i=0; i<2; ++i)
+        {
+            r->vIn[i]       = new float[samples];
+            r->vOut[i]      = new float[samples];
+            r->vGc[i]       = new float[samples];
+            memset(r->vIn[i], 0, samples * sizeof(float));
+        }
+        r->nLatency     = 0;
+    }
+
+    static void destroy_render(render_t *r)
+    {
+        for (size_t i=0; i<2; ++i)
+        {
+            delete [] r->vIn[i];
+            delete [] r->vOut[i];
+            delete [] r->vGc[i];
+        }
+    }
+
+    static float signal_level(test::signal_t type, const test::config_t *cfg)
+    {
+        return (type == test::SIG_EDGE) ? cfg->fThreshOn : LEVEL;
+    }
+}
+
+UTEST_BEGIN("surge_filter", equivalence)
+
+    /**
+     * Render the data through the plugin created with the specified metadata,
+     * the sidechain, if present, is fed with the input signal
+     */
+    void render(render_t *r, const meta::plugin_t *meta, const test::config_t *cfg,
+        size_t samples, const size_t *blocks, size_t count, bool ui, float link, bool bypass)
+    {
+        test::SurgeFilterHost host(meta);
+        UTEST_ASSERT(host.init(SAMPLE_RATE) == STATUS_OK);
+
+        host.apply(cfg);
+        host.set("link", link);
+        host.set_bypass(bypass);
+        host.set_ui_active(ui);
+
+        const float * const *sc = (host.sidechain()) ? r->vIn : NULL;
+        host.process(r->vOut, r->vIn, sc, r->vGc, samples, blocks, count);
+        r->nLatency     = host.latency();
+    }
+
+    void check_equal(const float *a, const float *b, size_t samples, const char *what,
+        const test::config_t *cfg, test::signal_t type)
+    {
+        for (size_t i=0; i<samples; ++i)
+        {
+            if (a[i] == b[i])
+                continue;
+
+            char buf[256];
+            test::config_format(buf, sizeof(buf), cfg);
+            UTEST_FAIL_MSG("%s: mismatch at sample %d: %.10g != %.10g, signal=%s, %s",
+                what, int(i), a[i], b[i], test::signal_name(type), buf);
+        }
+    }
+
+    // Processing must not depend on the size of blocks passed to the process() call
+    void check_blocks(render_t *ref, render_t *r, const test::config_t *cfg, test::signal_t type)
+    {
+        render(r, &meta::sc_surge_filter_mono, cfg, SAMPLES, irregular_blocks, sizeof(irregular_blocks)/sizeof(size_t), false, 1.0f, false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "irregular blocks output", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[0], SAMPLES, "irregular blocks gain curve", cfg, type);
+
+        render(r, &meta::sc_surge_filter_mono, cfg, SAMPLES, single_blocks, 1, false, 1.0f, false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "single-sample blocks output", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[0], SAMPLES, "single-sample blocks gain curve", cfg, type);
+    }
+
+    // Metering must not affect the processed signal
+    void check_metering(render_t *ref, render_t *r, const test::config_t *cfg, test::signal_t type)
+    {
+        render(r, &meta::surge_filter_mono, cfg, SAMPLES, regular_blocks, 1, true, 1.0f, false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "metering on", cfg, type);
+
+        render(r, &meta::surge_filter_mono, cfg, SAMPLES, regular_blocks, 1, false, 1.0f, false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "metering off", cfg, type);
+    }
+
+    // The output must be the delayed input multiplied by the gain curve, whatever the
+    // processing path was chosen for each block. If the latency changes, each sample
+    // should match one of the latencies
+    void check_gain_curve(render_t *ref, const test::config_t *cfg, test::signal_t type,
+        const ssize_t *latencies, size_t count)
+    {
+        for (size_t i=0; i<SAMPLES; ++i)
+        {
+            float wet       = 0.0f;
+            for (size_t j=0; j<count; ++j)
+            {
+                const ssize_t latency = latencies[j];
+                float dry       = (ssize_t(i) >= latency) ? ref->vIn[0][i - latency] : 0.0f;
+                wet             = dry * ref->vGc[0][i];
+                if (wet == ref->vOut[0][i])
+                    break;
+            }
+            if (wet == ref->vOut[0][i])
+                continue;
+
+            char buf[256];
+            test::config_format(buf, sizeof(buf), cfg);
+            UTEST_FAIL_MSG("gain curve: mismatch at sample %d: %.10g != %.10g, signal=%s, %s",
+                int(i), wet, ref->vOut[0][i], test::signal_name(type), buf);
+        }
+    }
+
+    void check_gain_curve(render_t *ref, const test::config_t *cfg, test::signal_t type)
+    {
+        check_gain_curve(ref, cfg, type, &ref->nLatency, 1);
+    }
+
+    // Get the latency of the plugin for the specified detection rate
+    ssize_t detector_latency(const meta::plugin_t *meta, const test::config_t *cfg, bool crate)
+    {
+        test::SurgeFilterHost host(meta);
+        UTEST_ASSERT(host.init(SAMPLE_RATE) == STATUS_OK);
+        host.apply(cfg);
+        host.set("crate", (crate) ? 1.0f : 0.0f);
+
+        float in = 0.0f, out = 0.0f, gc = 0.0f;
+        const float *vin    = &in;
+        float *vout         = &out;
+        float *vgc          = &gc;
+        host.process(&vout, &vin, (host.sidechain()) ? &vin : NULL, &vgc, 1, 1);
+
+        return host.latency();
+    }
+
+    // The bypassed plugin must output the delayed input signal
+    void check_bypass(render_t *ref, render_t *r, const test::config_t *cfg, test::signal_t type)
+    {
+        render(r, &meta::surge_filter_mono, cfg, SAMPLES, regular_blocks, 1, false, 1.0f, true);
+
+        // Skip the bypass cross-fade
+        const size_t skip       = SAMPLE_RATE / 20;
+        const ssize_t latency   = r->nLatency;
+        UTEST_ASSERT(latency == ref->nLatency);
+        for (size_t i=skip; i<SAMPLES; ++i)
+            ref->vGc[1][i]          = (ssize_t(i) >= latency) ? ref->vIn[0][i - latency] : 0.0f;
+        check_equal(&ref->vGc[1][skip], &r->vOut[0][skip], SAMPLES - skip, "bypass", cfg, type);
+    }
+
+    // Stereo processing of the same signal in both channels must give the same result as mono
+    void check_stereo(render_t *ref, render_t *r, const test::config_t *cfg, test::signal_t type)
+    {
+        memcpy(r->vIn[0], ref->vIn[0], SAMPLES * sizeof(float));
+        memcpy(r->vIn[1], ref->vIn[0], SAMPLES * sizeof(float));
+
+        render(r, &meta::sc_surge_filter_stereo, cfg, SAMPLES, regular_blocks, 1, false, 1.0f, false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "linked stereo left", cfg, type);
+        check_equal(ref->vOut[0], r->vOut[1], SAMPLES, "linked stereo right", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[0], SAMPLES, "linked stereo gain curve left", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[1], SAMPLES, "linked stereo gain curve right", cfg, type);
+
+        render(r, &meta::surge_filter_stereo, cfg, SAMPLES, regular_blocks, 1, true, 0.0f, false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "unlinked stereo left", cfg, type);
+        check_equal(ref->vOut[0], r->vOut[1], SAMPLES, "unlinked stereo right", cfg, type);
+    }
+
+    /**
+     * Render the data with toggling of the switch port at the specified points, the
+     * sidechain, if present, is fed with the input signal. If the latency is fixed,
+     * it should not change on switching
+     */
+    void render_switch(render_t *r, const meta::plugin_t *meta, const test::config_t *cfg,
+        const char *id, bool value, const size_t *points, size_t count, const size_t *blocks, size_t nblocks,
+        bool fixed_latency)
+    {
+        test::SurgeFilterHost host(meta);
+        UTEST_ASSERT(host.init(SAMPLE_RATE) == STATUS_OK);
+        host.apply(cfg);
+
+        for (size_t i=1; i<count; ++i, value = !value)
+        {
+            const size_t offset = points[i-1];
+            const float *in[2]  = { &r->vIn[0][offset], &r->vIn[1][offset] };
+            float *out[2]       = { &r->vOut[0][offset], &r->vOut[1][offset] };
+            float *gc[2]        = { &r->vGc[0][offset], &r->vGc[1][offset] };
+
+            host.set(id, (value) ? 1.0f : 0.0f);
+            host.process(out, in, (host.sidechain()) ? in : NULL, gc, points[i] - offset, blocks, nblocks);
+
+            if ((fixed_latency) && (i > 1))
+                UTEST_ASSERT_MSG(r->nLatency == host.latency(), "Latency has changed on switching %s\n", id);
+            r->nLatency     = host.latency();
+        }
+    }
+
+    // Only the detector of the first channel is running in linked mode, so the left channel
+    // and the right channel while linked stay the same as for mono. On unlink, the detector
+    // of the right channel is warmed up before its gain curve takes over, the output should
+    // stay the delayed input multiplied by the gain curve and converge to mono for DC
+    void check_link_switch(render_t *ref, render_t *r, const test::config_t *cfg, test::signal_t type)
+    {
+        static const size_t points[] = { 0, SAMPLES / 5, SAMPLES / 2, (SAMPLES * 3) / 4, SAMPLES };
+        static const float tolerance = 1e-3f;
+
+        memcpy(r->vIn[0], ref->vIn[0], SAMPLES * sizeof(float));
+        memcpy(r->vIn[1], ref->vIn[0], SAMPLES * sizeof(float));
+
+        render_switch(r, &meta::sc_surge_filter_stereo, cfg, "link", true,
+            points, sizeof(points)/sizeof(size_t), irregular_blocks, sizeof(irregular_blocks)/sizeof(size_t), true);
+
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "link switch left", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[0], SAMPLES, "link switch gain curve left", cfg, type);
+
+        // Linked intervals
+        for (size_t i=0; i<4; i += 2)
+        {
+            const size_t offset = points[i];
+            const size_t count  = points[i+1] - offset;
+            check_equal(&ref->vOut[0][offset], &r->vOut[1][offset], count, "link switch right", cfg, type);
+            check_equal(&ref->vGc[0][offset], &r->vGc[1][offset], count, "link switch gain curve right", cfg, type);
+        }
+
+        // Unlinked intervals
+        char buf[256];
+        for (size_t i=1; i<4; i += 2)
+        {
+            for (size_t j=points[i]; j<points[i+1]; ++j)
+            {
+                float dry       = (ssize_t(j) >= r->nLatency) ? r->vIn[1][j - r->nLatency] : 0.0f;
+                float wet       = dry * r->vGc[1][j];
+                if (wet != r->vOut[1][j])
+                {
+                    test::config_format(buf, sizeof(buf), cfg);
+                    UTEST_FAIL_MSG("link switch right: gain curve mismatch at sample %d: %.10g != %.10g, signal=%s, %s",
+                        int(j), wet, r->vOut[1][j], test::signal_name(type), buf);
+                }
+            }
+
+            if (type != test::SIG_DC)
+                continue;
+
+            const size_t tail   = (points[i+1] - points[i]) / 10;
+            for (size_t j=points[i+1] - tail; j<points[i+1]; ++j)
+            {
+                if (fabsf(ref->vGc[0][j] - r->vGc[1][j]) <= tolerance)
+                    continue;
+
+                test::config_format(buf, sizeof(buf), cfg);
+                UTEST_FAIL_MSG("link switch right: gain %.10g != %.10g at sample %d, signal=%s, %s",
+                    r->vGc[1][j], ref->vGc[0][j], int(j), test::signal_name(type), buf);
+            }
+        }
+    }
+
+    // Switching the detection rate must not depend on the block size and must keep the output
+    // aligned with the gain curve, the latency is one of latencies of both detection rates
+    void check_rate_switch(render_t *ref, render_t *r, const test::config_t *cfg, test::signal_t type)
+    {
+        static const size_t points[] = { 0, SAMPLES / 5, SAMPLES / 3, (SAMPLES * 3) / 4, SAMPLES };
+        const ssize_t latencies[] =
+        {
+            detector_latency(&meta::sc_surge_filter_mono, cfg, false),
+            detector_latency(&meta::sc_surge_filter_mono, cfg, true)
+        };
+
+        // The control-rate detection is set up immediately after initialization, so the
+        // latency is already the latency of the control-rate detector
+        UTEST_ASSERT((latencies[1] % 32) == 0);
+
+        memcpy(r->vIn[0], ref->vIn[0], SAMPLES * sizeof(float));
+        render_switch(ref, &meta::sc_surge_filter_mono, cfg, "crate", !cfg->bControlRate,
+            points, sizeof(points)/sizeof(size_t), regular_blocks, 1, false);
+        check_gain_curve(ref, cfg, type, latencies, sizeof(latencies)/sizeof(ssize_t));
+
+        render_switch(r, &meta::sc_surge_filter_mono, cfg, "crate", !cfg->bControlRate,
+            points, sizeof(points)/sizeof(size_t), irregular_blocks, sizeof(irregular_blocks)/sizeof(size_t), false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "detection rate switch output", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[0], SAMPLES, "detection rate switch gain curve", cfg, type);
+    }
+
+    // The detector which takes over on the detection rate switch must have the actual state:
+    // the gain for the steady signal above the threshold should stay at unity
+    void check_rate_handover(render_t *r)
+    {
+        static const size_t points[] = { 0, (SAMPLES * 3) / 5, (SAMPLES * 6) / 5, (SAMPLES * 9) / 5, SAMPLES * 2 };
+        const size_t length     = points[sizeof(points)/sizeof(size_t) - 1];
+
+        test::config_t cfg;
+        cfg.nModeIn         = 0;
+        cfg.nModeOut        = 0;
+        cfg.fThreshOn       = meta::surge_filter_metadata::THRESH_DFL;
+        cfg.fThreshOff      = meta::surge_filter_metadata::THRESH_DFL;
+        cfg.fRmsLen         = meta::surge_filter_metadata::RMS_DFL;
+        cfg.fFadeIn         = meta::surge_filter_metadata::FADEIN_DFL;
+        cfg.fFadeOut        = meta::surge_filter_metadata::FADEOUT_DFL;
+        cfg.fFadeInDelay    = meta::surge_filter_metadata::PAUSE_DFL;
+        cfg.fFadeOutDelay   = meta::surge_filter_metadata::PAUSE_DFL;
+        cfg.bControlRate    = false;
+
+        for (size_t crate=0; crate<2; ++crate)
+        {
+            test::generate_signal(r->vIn[0], length, test::SIG_DC, LEVEL, SAMPLE_RATE, 0);
+            render_switch(r, &meta::sc_surge_filter_mono, &cfg, "crate", crate,
+                points, sizeof(points)/sizeof(size_t), regular_blocks, 1, false);
+
+            for (size_t i=points[1]; i<length; ++i)
+            {
+                if (r->vGc[0][i] == GAIN_AMP_0_DB)
+                    continue;
+
+                UTEST_FAIL_MSG("detection rate hand-over: gain %.10g at sample %d, initial crate=%d\n",
+                    r->vGc[0][i], int(i), int(crate));
+            }
+        }
+    }
+
+    // Unlinked channels must be processed independently, linked channels must share the gain
+    void check_unlinked(render_t *ref, render_t *r, const test::config_t *cfg, test::signal_t type)
+    {
+        memcpy(r->vIn[0], ref->vIn[0], SAMPLES * sizeof(float));
+        test::generate_signal(r->vIn[1], SAMPLES, type, signal_level(type, cfg), SAMPLE_RATE, 5);
+
+        render(r, &meta::sc_surge_filter_stereo, cfg, SAMPLES, irregular_blocks, sizeof(irregular_blocks)/sizeof(size_t), false, 0.0f, false);
+        check_equal(ref->vOut[0], r->vOut[0], SAMPLES, "unlinked stereo left", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[0], SAMPLES, "unlinked stereo gain curve left", cfg, type);
+
+        // Process the right channel as mono and compare
+        memcpy(ref->vIn[1], ref->vIn[0], SAMPLES * sizeof(float));
+        memcpy(ref->vIn[0], r->vIn[1], SAMPLES * sizeof(float));
+        render(ref, &meta::sc_surge_filter_mono, cfg, SAMPLES, regular_blocks, 1, false, 1.0f, false);
+        check_equal(ref->vOut[0], r->vOut[1], SAMPLES, "unlinked stereo right", cfg, type);
+        check_equal(ref->vGc[0], r->vGc[1], SAMPLES, "unlinked stereo gain curve right", cfg, type);
+
+        render(r, &meta::sc_surge_filter_stereo, cfg, SAMPLES, regular_blocks, 1, false, 1.0f, false);
+        check_equal(r->vGc[0], r->vGc[1], SAMPLES, "linked stereo gain curves", cfg, type);
+    }
+
+    // The state after wake-up from the sleep mode must not depend on the duration of silence
+    void check_sleep(render_t *a, render_t *b, const test::config_t *cfg)
+    {
+        const size_t burst      = SAMPLE_RATE / 5;
+        const size_t tail       = (SAMPLE_RATE * 3) / 10;
+        const size_t gap_a      = SAMPLE_RATE;
+        const size_t gap_b      = (SAMPLE_RATE * 5) / 2;   // The difference is a multiple of the control period
+        const size_t length     = burst * 2 + gap_b + tail;
+
+        // Form signals
+        test::generate_signal(a->vIn[1], burst, test::SIG_NOISE, LEVEL, SAMPLE_RATE, 0);
+        memset(a->vIn[0], 0, length * sizeof(float));
+        memset(b->vIn[0], 0, length * sizeof(float));
+        memcpy(a->vIn[0], a->vIn[1], burst * sizeof(float));
+        memcpy(&a->vIn[0][burst + gap_a], a->vIn[1], burst * sizeof(float));
+        memcpy(b->vIn[0], a->vIn[1], burst * sizeof(float));
+        memcpy(&b->vIn[0][burst + gap_b], a->vIn[1], burst * sizeof(float));
+
+        render(a, &meta::surge_filter_mono, cfg, burst * 2 + gap_a + tail, regular_blocks, 1, false, 1.0f, false);
+        render(b, &meta::surge_filter_mono, cfg, length, regular_blocks, 1, false, 1.0f, false);
+
+        // The output at the end of each gap should be silent
+        const size_t check      = SAMPLE_RATE / 10;
+        for (size_t i=0; i<check; ++i)
+        {
+            a->vGc[1][i]            = 0.0f;
+        }
+        check_equal(a->vGc[1], &a->vOut[0][burst + gap_a - check], check, "sleep silence", cfg, test::SIG_NOISE);
+        check_equal(a->vGc[1], &b->vOut[0][burst + gap_b - check], check, "sleep silence", cfg, test::SIG_NOISE);
+
+        // The output after the gap should be the same
+        check_equal(&a->vOut[0][burst + gap_a], &b->vOut[0][burst + gap_b], burst + tail, "wake up", cfg, test::SIG_NOISE);
+
+        // The bypass switched in the sleep mode should complete the cross-fade before
+        // the plugin falls asleep again, so the output after the gap is the dry signal
+        {
+            test::SurgeFilterHost host(&meta::surge_filter_mono);
+            UTEST_ASSERT(host.init(SAMPLE_RATE) == STATUS_OK);
+            host.apply(cfg);
+
+            const size_t half   = burst + gap_a / 2;
+            const size_t total  = burst * 2 + gap_a + tail;
+            float *out          = b->vOut[0];
+            const float *in     = a->vIn[0];
+            host.process(&out, &in, NULL, NULL, half, regular_blocks, 1);
+            host.set_bypass(true);
+            out                += half;
+            in                 += half;
+            host.process(&out, &in, NULL, NULL, total - half, regular_blocks, 1);
+
+            const ssize_t latency   = host.latency();
+            const size_t offset     = burst + gap_a;
+            for (size_t i=0; i<burst + tail; ++i)
+            {
+                const ssize_t j     = ssize_t(offset + i) - latency;
+                b->vGc[1][i]        = (j >= 0) ? a->vIn[0][j] : 0.0f;
+            }
+            check_equal(b->vGc[1], &b->vOut[0][offset], burst + tail, "bypass in sleep mode", cfg, test::SIG_NOISE);
+        }
+    }
+
+    UTEST_MAIN
+    {
+        const size_t sleep_samples = SAMPLE_RATE * 4;
+        render_t ref, r, sa, sb;
+        init_render(&ref, SAMPLES);
+        init_render(&r, SAMPLES);
+        init_render(&sa, sleep_samples);
+        init_render(&sb, sleep_samples);
+
+        test::config_t cfg;
+        const size_t configs = test::config_grid_size();
+        for (size_t i=0; i<configs; ++i)
+        {
+            test::config_grid(&cfg, i);
+            if (verbose())
+            {
+                char buf[256];
+                test::config_format(buf, sizeof(buf), &cfg);
+                printf("Testing %s\n", buf);
+            }
+
+            for (size_t j=0; j<test::SIG_TOTAL; ++j)
+            {
+                test::signal_t type = test::signal_t(j);
+                test::generate_signal(ref.vIn[0], SAMPLES, type, signal_level(type, &cfg), SAMPLE_RATE, 0);
+                memcpy(r.vIn[0], ref.vIn[0], SAMPLES * sizeof(float));
+
+                render(&ref, &meta::sc_surge_filter_mono, &cfg, SAMPLES, regular_blocks, 1, false, 1.0f, false);
+                check_gain_curve(&ref, &cfg, type);
+                check_blocks(&ref, &r, &cfg, type);
+                check_metering(&ref, &r, &cfg, type);
+                check_bypass(&ref, &r, &cfg, type);
+                check_stereo(&ref, &r, &cfg, type);
+                check_link_switch(&ref, &r, &cfg, type);
+                check_unlinked(&ref, &r, &cfg, type);
+                check_rate_switch(&ref, &r, &cfg, type);
+            }
+
+            check_sleep(&sa, &sb, &cfg);
+        }
+
+        check_rate_handover(&sa);
+
+        destroy_render(&ref);
+        destroy_render(&r);
+        destroy_render(&sa);
+        destroy_render(&sb);
+    }
+
+UTEST_END
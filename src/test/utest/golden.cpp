@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <private/meta/surge_filter.h>
+#include <private/test/config.h>
+#include <private/test/signal.h>
+#include <private/test/surge_filter_host.h>
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t SAMPLES         = SAMPLE_RATE / 2;
+    static constexpr size_t BLOCK_SIZE      = 1024;
+    static constexpr float LEVEL            = 0.25f;
+    static constexpr size_t CONFIG_STEP     = 25;
+    static constexpr size_t POINTS          = 32;
+    static constexpr size_t WINDOW          = SAMPLES / POINTS;
+    static constexpr ssize_t POS_TOLERANCE  = 2;
+    static constexpr double TOLERANCE       = 1e-3;
+
+    enum layout_t
+    {
+        L_MONO,
+        L_STEREO,
+        L_SC_MONO,
+        L_SC_LINKED,
+        L_SC_UNLINKED,
+
+        L_TOTAL
+    };
+
+    typedef struct layout_desc_t
+    {
+        const char             *name;       // Name of the layout
+        const meta::plugin_t   *meta;       // Plugin metadata
+        float                   link;       // Stereo link
+    } layout_desc_t;
+
+    static const layout_desc_t layouts[] =
+    {
+        { "mono",           &meta::surge_filter_mono,       1.0f },
+        { "stereo",         &meta::surge_filter_stereo,     1.0f },
+        { "sc_mono",        &meta::sc_surge_filter_mono,    1.0f },
+        { "sc_linked",      &meta::sc_surge_filter_stereo,  1.0f },
+        { "sc_unlinked",    &meta::sc_surge_filter_stereo,  0.0f }
+    };
+
+    /**
+     * Signature of the processed channel: the output is decimated to the peak levels
+     * of consecutive windows, the gain curve is decimated to the minimums of the gain
+     * of consecutive windows, so fade-in and fade-out changes of each window are captured
+     */
+    typedef struct signature_t
+    {
+        size_t      nLayout;        // Channel layout
+        size_t      nConfig;        // Index of configuration in the grid
+        size_t      nSignal;        // Signal type
+        size_t      nChannel;       // Channel number
+        ssize_t     nFirst;         // First non-zero output sample, -1 if none
+        ssize_t     nLast;          // Last non-zero output sample, -1 if none
+        double      vPeak[POINTS];  // Peak output levels
+        double      vGain[POINTS];  // Minimum gain, versions without sidechain use the ratio of output and input
+    } signature_t;
+
+    static void make_signature(signature_t *sig, const float *in, const float *out, const float *gc,
+        ssize_t latency)
+    {
+        sig->nFirst     = -1;
+        sig->nLast      = -1;
+
+        for (size_t i=0; i<POINTS; ++i)
+        {
+            double peak     = 0.0;
+            double gain     = 1.0;
+            for (size_t j=i*WINDOW, end=j+WINDOW; j<end; ++j)
+            {
+                double s        = out[j];
+                if (s != 0.0)
+                {
+                    if (sig->nFirst < 0)
+                        sig->nFirst     = j;
+                    sig->nLast      = j;
+                }
+                peak            = lsp_max(peak, fabs(s));
+
+                if (gc != NULL)
+                    gain            = lsp_min(gain, double(gc[j]));
+                else if ((ssize_t(j) >= latency) && (in[j - latency] != 0.0f))
+                    gain            = lsp_min(gain, fabs(s / in[j - latency]));
+            }
+            sig->vPeak[i]   = peak;
+            sig->vGain[i]   = gain;
+        }
+    }
+
+    static bool close_enough(double a, double b)
+    {
+        return fabs(a - b) <= TOLERANCE * lsp_max(lsp_max(fabs(a), fabs(b)), 1e-6);
+    }
+
+    static bool parse_values(double *dst, char **line)
+    {
+        char *end;
+        for (size_t i=0; i<POINTS; ++i)
+        {
+            if ((i > 0) && (*((*line)++) != ','))
+                return false;
+            dst[i]          = strtod(*line, &end);
+            if (end == *line)
+                return false;
+            *line           = end;
+        }
+        return true;
+    }
+}
+
+UTEST_BEGIN("surge_filter", golden)
+
+    size_t render(signature_t *sig, float * const *in, float * const *out, float * const *gc,
+        size_t layout, size_t index, const test::config_t *cfg, test::signal_t type)
+    {
+        const layout_desc_t *l  = &layouts[layout];
+        const float level   = (type == test::SIG_EDGE) ? cfg->fThreshOn : LEVEL;
+        test::generate_signal(in[0], SAMPLES, type, level, SAMPLE_RATE, 0);
+        test::generate_signal(in[1], SAMPLES, type, level * 0.5f, SAMPLE_RATE, 3);
+
+        test::SurgeFilterHost host(l->meta);
+        UTEST_ASSERT(host.init(SAMPLE_RATE) == STATUS_OK);
+        host.apply(cfg);
+        host.set("link", l->link);
+        host.process(out, in, (host.sidechain()) ? in : NULL, gc, SAMPLES, BLOCK_SIZE);
+
+        for (size_t i=0; i<host.channels(); ++i, ++sig)
+        {
+            sig->nLayout    = layout;
+            sig->nConfig    = index;
+            sig->nSignal    = type;
+            sig->nChannel   = i;
+            make_signature(sig, in[i], out[i], (host.sidechain()) ? gc[i] : NULL, host.latency());
+        }
+
+        return host.channels();
+    }
+
+    void write_signatures(const char *path, const signature_t *sig, size_t count)
+    {
+        FILE *fd = fopen(path, "w");
+        UTEST_ASSERT_MSG(fd != NULL, "Could not create file %s\n", path);
+
+        for (size_t i=0; i<count; ++i, ++sig)
+        {
+            fprintf(fd, "%s;%d;%s;%d;%ld;%ld;",
+                layouts[sig->nLayout].name, int(sig->nConfig), test::signal_name(test::signal_t(sig->nSignal)),
+                int(sig->nChannel), long(sig->nFirst), long(sig->nLast));
+            for (size_t j=0; j<POINTS; ++j)
+                fprintf(fd, (j > 0) ? ",%.6e" : "%.6e", sig->vPeak[j]);
+            fputc(';', fd);
+            for (size_t j=0; j<POINTS; ++j)
+                fprintf(fd, (j > 0) ? ",%.6e" : "%.6e", sig->vGain[j]);
+            fputc('\n', fd);
+        }
+
+        fclose(fd);
+    }
+
+    void check_signatures(const char *path, const char *actual, const signature_t *sig, size_t count)
+    {
+        FILE *fd = fopen(path, "r");
+        UTEST_ASSERT_MSG(fd != NULL,
+            "Golden file %s not found, it should be recorded from the reference build, the actual data is in %s\n",
+            path, actual);
+
+        char line[2048], layout[32], signal[32], buf[256];
+        double peak[POINTS], gain[POINTS];
+        size_t checked = 0;
+        test::config_t cfg;
+
+        for ( ; fgets(line, sizeof(line), fd) != NULL; ++checked, ++sig)
+        {
+            UTEST_ASSERT_MSG(checked < count, "Golden file contains more records than expected\n");
+
+            int config, channel, length = 0;
+            long first, last;
+            int fields = sscanf(line, "%31[^;];%d;%31[^;];%d;%ld;%ld;%n",
+                layout, &config, signal, &channel, &first, &last, &length);
+            char *p = &line[length];
+            bool valid = (fields == 6) && (length > 0) &&
+                (parse_values(peak, &p)) && (*(p++) == ';') && (parse_values(gain, &p));
+            UTEST_ASSERT_MSG(valid, "Malformed golden record %d\n", int(checked));
+
+            UTEST_ASSERT_MSG(
+                (!strcmp(layout, layouts[sig->nLayout].name)) &&
+                (config == int(sig->nConfig)) &&
+                (!strcmp(signal, test::signal_name(test::signal_t(sig->nSignal)))) &&
+                (channel == int(sig->nChannel)),
+                "Golden record %d does not match the test grid, the golden file needs to be updated\n", int(checked));
+
+            ssize_t point = -1;
+            if ((labs(first - long(sig->nFirst)) > POS_TOLERANCE) || (labs(last - long(sig->nLast)) > POS_TOLERANCE))
+                point = 0;
+            for (size_t i=0; (point < 0) && (i<POINTS); ++i)
+            {
+                if ((!close_enough(peak[i], sig->vPeak[i])) || (!close_enough(gain[i], sig->vGain[i])))
+                    point = i;
+            }
+            if (point < 0)
+                continue;
+
+            test::config_grid(&cfg, config);
+            test::config_format(buf, sizeof(buf), &cfg);
+            fclose(fd);
+            UTEST_FAIL_MSG("Golden output mismatch: layout=%s signal=%s channel=%d %s\n"
+                "  expected: first=%ld last=%ld window=%d peak=%.6e gain=%.6e\n"
+                "  actual:   first=%ld last=%ld window=%d peak=%.6e gain=%.6e\n",
+                layout, signal, channel, buf,
+                first, last, int(point), peak[point], gain[point],
+                long(sig->nFirst), long(sig->nLast), int(point), sig->vPeak[point], sig->vGain[point]);
+        }
+
+        fclose(fd);
+        UTEST_ASSERT_MSG(checked == count, "Golden file contains %d records, expected %d\n", int(checked), int(count));
+    }
+
+    UTEST_MAIN
+    {
+        float *in[2], *out[2], *gc[2];
+        for (size_t i=0; i<2; ++i)
+        {
+            in[i]       = new float[SAMPLES];
+            out[i]      = new float[SAMPLES];
+            gc[i]       = new float[SAMPLES];
+        }
+
+        // Render all layouts, the subset of configurations and all signals. The step over the
+        // configuration grid is odd, so both detection rates are covered
+        const size_t configs    = (test::config_grid_size() + CONFIG_STEP - 1) / CONFIG_STEP;
+        const size_t count      = configs * test::SIG_TOTAL * 8;
+        signature_t *vsig       = new signature_t[count];
+        signature_t *sig        = vsig;
+
+        test::config_t cfg;
+        for (size_t layout=0; layout<L_TOTAL; ++layout)
+            for (size_t i=0; i<test::config_grid_size(); i += CONFIG_STEP)
+            {
+                test::config_grid(&cfg, i);
+                for (size_t j=0; j<test::SIG_TOTAL; ++j)
+                {
+                    sig        += render(sig, in, out, gc, layout, i, &cfg, test::signal_t(j));
+                }
+            }
+
+        // Store the actual signatures, this file becomes the golden file when the
+        // processing is changed intentionally
+        char path[PATH_MAX], actual[PATH_MAX];
+        snprintf(actual, sizeof(actual), "%s/%s.csv", tempdir(), full_name());
+        printf("Writing signatures to file %s\n", actual);
+        write_signatures(actual, vsig, sig - vsig);
+
+        // Compare with the golden file
+        snprintf(path, sizeof(path), "%s/surge_filter/golden.csv", resources());
+        check_signatures(path, actual, vsig, sig - vsig);
+
+        delete [] vsig;
+        for (size_t i=0; i<2; ++i)
+        {
+            delete [] in[i];
+            delete [] out[i];
+            delete [] gc[i];
+        }
+    }
+
+UTEST_END
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-surge-filter
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-plugins-surge-filter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-surge-filter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-surge-filter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <private/meta/surge_filter.h>
+#include <private/plugins/surge_filter.h>
+#include <private/test/config.h>
+#include <private/test/surge_filter_host.h>
+
+#include <string.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr long SAMPLE_RATE       = 48000;
+    static constexpr size_t PERIOD          = SAMPLE_RATE / 50;     // 20 ms: 10 ms of signal, 10 ms of silence
+    static constexpr size_t CHUNK           = SAMPLE_RATE / 10;     // 100 ms, five periods
+    static constexpr size_t LOG_CAPACITY    = 0x100;                // Capacity of the transition log
+    static constexpr size_t EVENTS_MAX      = 0x400;
+
+    typedef plugins::surge_filter::transition_t transition_t;
+}
+
+UTEST_BEGIN("surge_filter", transitions)
+
+    void init_host(test::SurgeFilterHost *host)
+    {
+        test::config_t cfg;
+        cfg.nModeIn         = 0;
+        cfg.nModeOut        = 0;
+        cfg.fThreshOn       = GAIN_AMP_M_36_DB;
+        cfg.fThreshOff      = GAIN_AMP_M_36_DB;
+        cfg.fRmsLen         = 4.0f;
+        cfg.fFadeIn         = 1.0f;
+        cfg.fFadeOut        = 1.0f;
+        cfg.fFadeInDelay    = 0.0f;
+        cfg.fFadeOutDelay   = 0.0f;
+        cfg.bControlRate    = false;
+
+        UTEST_ASSERT(host->init(SAMPLE_RATE) == STATUS_OK);
+        host->apply(&cfg);
+    }
+
+    // Process the chunk of periodic bursts, each period should emit one open and one close event
+    void process_chunk(test::SurgeFilterHost *host, float *in, float *out)
+    {
+        for (size_t i=0; i<CHUNK; ++i)
+            in[i]           = ((i % PERIOD) < (PERIOD / 2)) ? 0.25f : 0.0f;
+
+        float *vin[1]   = { in };
+        float *vout[1]  = { out };
+        host->process(vout, vin, NULL, NULL, CHUNK, 1024);
+    }
+
+    // Events should alternate between opening and closing and should be ordered in time
+    void check_events(const transition_t *ev, size_t count, const transition_t *prev)
+    {
+        for (size_t i=0; i<count; ++i)
+        {
+            const transition_t *t = &ev[i];
+            UTEST_ASSERT(t->nChannel == 0);
+            if (prev == NULL)
+                UTEST_ASSERT_MSG(t->nDirection == plugins::surge_filter::TD_OPEN, "First event should be opening\n");
+            else
+            {
+                UTEST_ASSERT_MSG(t->nDirection != prev->nDirection,
+                    "Event %d has the same direction as the previous one\n", int(i));
+                UTEST_ASSERT_MSG(t->nPosition > prev->nPosition,
+                    "Event %d at position %d is not after the previous one at %d\n",
+                    int(i), int(t->nPosition), int(prev->nPosition));
+            }
+            prev        = t;
+        }
+    }
+
+    // Reading events regularly should pass many times over the end of the ring buffer without loss
+    void test_wrap(float *in, float *out, transition_t *ev)
+    {
+        test::SurgeFilterHost host(&meta::surge_filter_mono);
+        init_host(&host);
+        plugins::surge_filter *sf = static_cast<plugins::surge_filter *>(host.module());
+
+        transition_t last;
+        size_t total = 0;
+        for (size_t i=0; i<100; ++i)
+        {
+            process_chunk(&host, in, out);
+            size_t n = sf->read_transitions(ev, EVENTS_MAX);
+            UTEST_ASSERT_MSG(n < LOG_CAPACITY, "Too many events in one chunk: %d\n", int(n));
+            check_events(ev, n, (total > 0) ? &last : NULL);
+            if (n > 0)
+                last        = ev[n-1];
+            total      += n;
+        }
+
+        printf("Read %d events\n", int(total));
+        UTEST_ASSERT(sf->lost_transitions() == 0);
+        UTEST_ASSERT_MSG(total > LOG_CAPACITY * 3, "Too few events: %d\n", int(total));
+        UTEST_ASSERT(sf->read_transitions(ev, EVENTS_MAX) == 0);
+    }
+
+    // Events which do not fit into the ring buffer should be dropped and counted, the
+    // events already stored should be kept intact
+    void test_overflow(float *in, float *out, transition_t *ev)
+    {
+        test::SurgeFilterHost host(&meta::surge_filter_mono);
+        init_host(&host);
+        plugins::surge_filter *sf = static_cast<plugins::surge_filter *>(host.module());
+
+        // Emit more events than the log can store
+        for (size_t i=0; i<40; ++i)
+            process_chunk(&host, in, out);
+
+        wsize_t lost = sf->lost_transitions();
+        size_t n = sf->read_transitions(ev, EVENTS_MAX);
+        printf("Read %d events, lost %d events\n", int(n), int(lost));
+        UTEST_ASSERT(n == LOG_CAPACITY);
+        UTEST_ASSERT(lost > 0);
+        check_events(ev, n, NULL);
+        UTEST_ASSERT(sf->read_transitions(ev, EVENTS_MAX) == 0);
+
+        // The log should work after the overflow
+        transition_t last = ev[n-1];
+        process_chunk(&host, in, out);
+        n = sf->read_transitions(ev, EVENTS_MAX);
+        UTEST_ASSERT(n > 0);
+        UTEST_ASSERT(ev[0].nPosition > last.nPosition);
+        UTEST_ASSERT(sf->lost_transitions() == lost);
+    }
+
+    UTEST_MAIN
+    {
+        float *in           = new float[CHUNK];
+        float *out          = new float[CHUNK];
+        transition_t *ev    = new transition_t[EVENTS_MAX];
+
+        test_wrap(in, out, ev);
+        test_overflow(in, out, ev);
+
+        delete [] ev;
+        delete [] out;
+        delete [] in;
+    }
+
+UTEST_END